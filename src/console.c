@@ -1470,9 +1470,6 @@ static void CON_DrawHudlines(void)
 
 	for (i = con_cy - con_hudlines+1; i <= con_cy; i++)
 	{
-		size_t c;
-		INT32 x;
-
 		if ((signed)i < 0)
 			continue;
 		if (con_hudtime[i%con_hudlines] == 0)
@@ -1480,23 +1477,9 @@ static void CON_DrawHudlines(void)
 
 		p = (UINT8 *)&con_buffer[(i%con_totallines)*con_width];
 
-		for (c = 0, x = 0; c < con_width; c++, x += charwidth, p++)
-		{
-			while (*p & 0x80) // Graue 06-19-2004
-			{
-				charflags = (*p & 0x7f) << V_CHARCOLORSHIFT;
-				p++;
-			}
-			if (*p < HU_FONTSTART)
-				;//charwidth = 4 * con_scalefactor;
-			else
-			{
-				//charwidth = SHORT(hu_font['A'-HU_FONTSTART]->width) * con_scalefactor;
-				V_DrawCharacter(x, y, (INT32)(*p) | charflags | cv_constextsize.value | V_NOSCALESTART, !cv_allcaps.value);
-			}
-		}
+		charflags = V_DrawConsoleLine(0, y, charflags, cv_constextsize.value | V_NOSCALESTART, charwidth,
+			p, con_width, !cv_allcaps.value);
 
-		//V_DrawCharacter(x, y, (p[c]&0xff) | cv_constextsize.value | V_NOSCALESTART, !cv_allcaps.value);
 		y += charheight;
 	}
 
@@ -1555,20 +1538,9 @@ static void CON_DrawConsole(void)
 
 	for (y = (con_curlines-minheight) % charheight; y <= con_curlines-minheight; y += charheight, i++)
 	{
-		INT32 x;
-		size_t c;
-
 		p = (UINT8 *)&con_buffer[((i > 0 ? i : 0)%con_totallines)*con_width];
-
-		for (c = 0, x = charwidth; c < con_width; c++, x += charwidth, p++)
-		{
-			while (*p & 0x80)
-			{
-				charflags = (*p & 0x7f) << V_CHARCOLORSHIFT;
-				p++;
-			}
-			V_DrawCharacter(x, y, (INT32)(*p) | charflags | cv_constextsize.value | V_NOSCALESTART, !cv_allcaps.value);
-		}
+		charflags = V_DrawConsoleLine(charwidth, y, charflags, cv_constextsize.value | V_NOSCALESTART, charwidth,
+			p, con_width, !cv_allcaps.value);
 	}
 
 	// draw prompt if enough place (not while game startup)
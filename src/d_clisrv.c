@@ -39,6 +39,7 @@
 #include "mserv.h"
 #include "y_inter.h"
 #include "r_local.h"
+#include "r_fps.h" // R_InterpolatingFrame
 #include "m_argv.h"
 #include "p_setup.h"
 #include "lzf.h"
@@ -4746,6 +4747,12 @@ void NetUpdate(void)
 	INT32 i;
 	INT32 realtics;
 
+	// The renderers call this partway through drawing the view. If that
+	// view is interpolated, mobjs and sectors aren't where the game has
+	// them, and nothing may be sent or saved until they're put back.
+	if (R_InterpolatingFrame())
+		return;
+
 	nowtime = I_GetTime();
 	realtics = nowtime - gametime;
 
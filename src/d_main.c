@@ -58,6 +58,7 @@ int	snprintf(char *str, size_t n, const char *fmt, ...);
 #include "p_saveg.h"
 #include "r_main.h"
 #include "r_local.h"
+#include "r_fps.h" // frame interpolation
 #include "s_sound.h"
 #include "st_stuff.h"
 #include "v_video.h"
@@ -111,6 +112,7 @@ UINT8 window_notinfocus = false;
 //static INT32 demosequence;
 static const char *pagename = "MAP1PIC";
 static char *startupwadfiles[MAX_WADFILES];
+static char renderbench[256] = ""; // -renderbench command to run once the level is up
 
 boolean devparm = false; // started game with -devparm
 
@@ -237,6 +239,8 @@ static void D_Display(void)
 	if (nodrawers)
 		return; // for comparative timing/profiling
 
+	R_RecordFrameTime();
+
 	// check for change of screen size (video mode)
 	if (setmodeneeded && !wipe)
 		SCR_SetMode(); // change video mode
@@ -351,9 +355,20 @@ static void D_Display(void)
 		// draw the view directly
 		if (cv_renderview.value && !automapactive)
 		{
+			precise_t frametime = 0, timer;
+
+			if (cv_renderstats.value && rendermode == render_soft)
+			{
+				R_ResetTimers();
+				rendertimers = true;
+				frametime = I_GetPreciseTime();
+			}
+
+			R_BeginInterpolatedFrame();
+
 			if (players[displayplayer].mo || players[displayplayer].playerstate == PST_DEAD)
 			{
-				topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
+				R_SetViewContext(0);
 				objectsdrawn = 0;
 #ifdef HWRENDER
 				if (rendermode != render_soft)
@@ -374,25 +389,29 @@ static void D_Display(void)
 #endif
 				if (rendermode != render_none)
 				{
-					viewwindowy = vid.height / 2;
-					M_Memcpy(ylookup, ylookup2, viewheight*sizeof (ylookup[0]));
-
-					topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
-
+					R_SetViewContext(1);
 					R_RenderPlayerView(&players[secondarydisplayplayer]);
-
-					viewwindowy = 0;
-					M_Memcpy(ylookup, ylookup1, viewheight*sizeof (ylookup[0]));
+					R_SetViewContext(0);
 				}
 			}
 
+			R_EndInterpolatedFrame();
+
 			// Image postprocessing effect
 			if (rendermode == render_soft)
 			{
+				timer = R_StartTimer();
 				if (postimgtype)
 					V_DoPostProcessor(0, postimgtype, postimgparam);
 				if (postimgtype2)
 					V_DoPostProcessor(1, postimgtype2, postimgparam2);
+				R_LapTimer(timer, RT_POSTPROCESS);
+			}
+
+			if (rendertimers)
+			{
+				rendertimers = false;
+				R_RecordRenderStats(I_GetPreciseTime() - frametime);
 			}
 		}
 
@@ -408,6 +427,9 @@ static void D_Display(void)
 
 		ST_Drawer();
 		HU_Drawer();
+
+		if (cv_renderstats.value && rendermode == render_soft)
+			R_DrawRenderStats();
 	}
 
 	// change gamma if needed
@@ -565,7 +587,18 @@ void D_SRB2Loop(void)
 
 		if (!realtics && !singletics)
 		{
-			I_Sleep();
+			// No tic to run, but there may be time to draw one between them
+			if (R_InterpolatedFrameDue())
+			{
+				D_Display();
+				if (takescreenshot)
+					M_DoScreenShot();
+				// The renderer's own calls are skipped while the
+				// view is interpolated; catch up now it's put back.
+				NetUpdate();
+			}
+			else
+				I_Sleep();
 			continue;
 		}
 
@@ -611,6 +644,17 @@ void D_SRB2Loop(void)
 			if (takescreenshot) // Only take screenshots after drawing.
 				M_DoScreenShot();
 		}
+		else if (R_InterpolatedFrameDue())
+		{
+			D_Display();
+			NetUpdate();
+		}
+
+		if (renderbench[0] && gamestate == GS_LEVEL && leveltime > 1)
+		{
+			COM_ImmedExecute(renderbench);
+			I_Quit();
+		}
 
 		// consoleplayer -> displayplayer (hear sounds from viewpoint)
 		S_UpdateSounds(); // move positional sounds
@@ -1315,6 +1359,22 @@ void D_SRB2Main(void)
 		ultimatemode = true;
 	}
 
+	// -renderbench [<views>|<file>] [<frames>]: time drawing the level -warp
+	// goes to, then quit
+	if (M_CheckParm("-renderbench"))
+	{
+		strcpy(renderbench, "renderbench");
+		while (M_IsNextParm())
+		{
+			const char *parm = M_GetNextParm();
+			if (strlen(renderbench) + strlen(parm) + 4 >= sizeof (renderbench))
+				break;
+			strcat(renderbench, " \"");
+			strcat(renderbench, parm);
+			strcat(renderbench, "\"");
+		}
+	}
+
 	if (autostart || netgame)
 	{
 		gameaction = ga_nothing;
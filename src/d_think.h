@@ -49,6 +49,10 @@ typedef struct thinker_s
 	// killough 11/98: count of how many other objects reference
 	// this one using pointers. Used for garbage collection.
 	INT32 references;
+
+	// Increases along the list for thinkers added by P_AddThinker,
+	// so the list order can be recovered without walking the list.
+	UINT32 serial;
 } thinker_t;
 
 #endif
@@ -28,6 +28,7 @@
 #include <io.h>
 #include <stdarg.h>
 #include <sys/time.h>
+#include <time.h> // uclock
 #include <fcntl.h>
 
 #ifdef DJGPP
@@ -1733,6 +1734,23 @@ char *I_ClipboardPaste(void)
 	return NULL;
 }
 
+void I_RunParallel(INT32 count, void (*func)(INT32 index, void *userdata), void *userdata)
+{
+	INT32 i;
+	for (i = 0; i < count; i++)
+		func(i, userdata);
+}
+
+precise_t I_GetPreciseTime(void)
+{
+	return (precise_t)uclock();
+}
+
+int I_PreciseToMicros(precise_t d)
+{
+	return (int)(d * 1000000 / UCLOCKS_PER_SEC);
+}
+
 const CPUInfoFlags *I_CPUInfo(void)
 {
 	static CPUInfoFlags DOS_CPUInfo;
@@ -71,6 +71,7 @@ extern INT32 lastwipetic;
 void F_WipeStartScreen(void);
 void F_WipeEndScreen(void);
 void F_RunWipe(UINT8 wipetype, boolean drawMenu);
+boolean F_WipeBenchFrame(UINT8 wipetype, UINT8 wipeframe);
 
 enum
 {
@@ -167,6 +167,47 @@ static fademask_t *F_GetFadeMask(UINT8 masknum, UINT8 scrnnum) {
 	return NULL;
 }
 
+// Where each column and row of the fade mask starts on the screen. Kept
+// between frames, since every frame of a wipe is the same size.
+static UINT16 *wipe_scrxpos = NULL;
+static UINT16 *wipe_scrypos = NULL;
+static UINT16 wipe_maskwidth = 0, wipe_maskheight = 0;
+static INT32 wipe_vidwidth = 0, wipe_vidheight = 0;
+
+/**	Works out the screen positions of the fade mask's columns and rows,
+  * unless the last frame already did.
+  *
+  * \param	fademask	the mask being drawn
+  */
+static void F_WipePositions(fademask_t *fademask)
+{
+	UINT32 relativepos;
+	UINT16 maskx, masky;
+
+	if (fademask->width == wipe_maskwidth && fademask->height == wipe_maskheight
+		&& vid.width == wipe_vidwidth && vid.height == wipe_vidheight)
+		return;
+
+	wipe_scrxpos = Z_Realloc(wipe_scrxpos, (fademask->width + 1) * sizeof(UINT16), PU_STATIC, NULL);
+	wipe_scrypos = Z_Realloc(wipe_scrypos, (fademask->height + 1) * sizeof(UINT16), PU_STATIC, NULL);
+
+	// Screw it, we do the fixed point math ourselves up front.
+	wipe_scrxpos[0] = 0;
+	for (relativepos = 0, maskx = 1; maskx < fademask->width; ++maskx)
+		wipe_scrxpos[maskx] = (relativepos += fademask->xscale)>>FRACBITS;
+	wipe_scrxpos[fademask->width] = vid.width;
+
+	wipe_scrypos[0] = 0;
+	for (relativepos = 0, masky = 1; masky < fademask->height; ++masky)
+		wipe_scrypos[masky] = (relativepos += fademask->yscale)>>FRACBITS;
+	wipe_scrypos[fademask->height] = vid.height;
+
+	wipe_maskwidth = fademask->width;
+	wipe_maskheight = fademask->height;
+	wipe_vidwidth = vid.width;
+	wipe_vidheight = vid.height;
+}
+
 /**	Wipe ticker
   *
   * \param	fademask	pixels to change
@@ -174,117 +215,57 @@ static fademask_t *F_GetFadeMask(UINT8 masknum, UINT8 scrnnum) {
 static void F_DoWipe(fademask_t *fademask)
 {
 	// Software mask wipe -- optimized; though it might not look like it!
-	// Okay, to save you wondering *how* this is more optimized than the simpler
-	// version that came before it...
 	// ---
-	// The previous code did two FixedMul calls for every single pixel on the
-	// screen, of which there are hundreds of thousands -- if not millions -- of.
-	// This worked fine for smaller screen sizes, but with excessively large
-	// (1920x1200) screens that meant 4 million+ calls out to FixedMul, and that
-	// would take /just/ long enough that fades would start to noticably lag.
+	// The first version of this did two FixedMul calls for every single pixel
+	// on the screen, which at 1920x1200 was enough to make fades lag. The one
+	// after it worked out where each fade mask pixel lands on the screen up
+	// front, then filled each of those rectangles in turn.
 	// ---
-	// This code iterates over the fade mask's pixels instead of the screen's,
-	// and deals with drawing over each rectangular area before it moves on to
-	// the next pixel in the fade mask.  As a result, it's more complex (and might
-	// look a little messy; sorry!) but it simultaneously runs at twice the speed.
-	// In addition, we precalculate all the X and Y positions that we need to draw
-	// from and to, so it uses a little extra memory, but again, helps it run faster.
+	// This one still uses those positions, but goes down the screen a line at
+	// a time, so the three screens are read and written in order. Along each
+	// line, neighbouring mask pixels with the same level are done together:
+	// one memcpy for fully faded or unfaded stretches, or one blending loop.
+	UINT8       *w_base = wipe_scr, *w;
+	const UINT8 *s_base = wipe_scr_start, *s;
+	const UINT8 *e_base = wipe_scr_end, *e;
+	const UINT8 *maskrow;
+	const UINT8 *transtbl;
+	UINT16 maskx, masky, runend;
+	UINT32 x, y, x1, x2, relativepos;
+	UINT8 level;
+
+	F_WipePositions(fademask);
+
+	for (masky = 0, maskrow = fademask->mask; masky < fademask->height; ++masky, maskrow += fademask->width)
 	{
-		// wipe screen, start, end
-		UINT8       *w = wipe_scr;
-		const UINT8 *s = wipe_scr_start;
-		const UINT8 *e = wipe_scr_end;
-
-		// first pixel for each screen
-		UINT8       *w_base = w;
-		const UINT8 *s_base = s;
-		const UINT8 *e_base = e;
-
-		// mask data, end
-		UINT8       *transtbl;
-		const UINT8 *mask    = fademask->mask;
-		const UINT8 *maskend = mask + fademask->size;
-
-		// rectangle draw hints
-		UINT32 draw_linestart, draw_rowstart;
-		UINT32 draw_lineend,   draw_rowend;
-		UINT32 draw_linestogo, draw_rowstogo;
-
-		// rectangle coordinates, etc.
-		UINT16* scrxpos = (UINT16*)malloc((fademask->width + 1)  * sizeof(UINT16));
-		UINT16* scrypos = (UINT16*)malloc((fademask->height + 1) * sizeof(UINT16));
-		UINT16 maskx, masky;
-		UINT32 relativepos;
-
-		// ---
-		// Screw it, we do the fixed point math ourselves up front.
-		scrxpos[0] = 0;
-		for (relativepos = 0, maskx = 1; maskx < fademask->width; ++maskx)
-			scrxpos[maskx] = (relativepos += fademask->xscale)>>FRACBITS;
-		scrxpos[fademask->width] = vid.width;
-
-		scrypos[0] = 0;
-		for (relativepos = 0, masky = 1; masky < fademask->height; ++masky)
-			scrypos[masky] = (relativepos += fademask->yscale)>>FRACBITS;
-		scrypos[fademask->height] = vid.height;
-		// ---
-
-		maskx = masky = 0;
-		do
+		for (y = wipe_scrypos[masky]; y < wipe_scrypos[masky + 1]; ++y)
 		{
-			draw_rowstart = scrxpos[maskx];
-			draw_rowend   = scrxpos[maskx + 1];
-			draw_linestart = scrypos[masky];
-			draw_lineend   = scrypos[masky + 1];
-
-			relativepos = (draw_linestart * vid.width) + draw_rowstart;
-			draw_linestogo = draw_lineend - draw_linestart;
-
-			if (*mask == 0)
-			{
-				// shortcut - memcpy source to work
-				while (draw_linestogo--)
-				{
-					M_Memcpy(w_base+relativepos, s_base+relativepos, draw_rowend-draw_rowstart);
-					relativepos += vid.width;
-				}
-			}
-			else if (*mask == 10)
+			for (maskx = 0; maskx < fademask->width; maskx = runend)
 			{
-				// shortcut - memcpy target to work
-				while (draw_linestogo--)
-				{
-					M_Memcpy(w_base+relativepos, e_base+relativepos, draw_rowend-draw_rowstart);
-					relativepos += vid.width;
-				}
-			}
-			else
-			{
-				// pointer to transtable that this mask would use
-				transtbl = transtables + ((9 - *mask)<<FF_TRANSSHIFT);
-
-				// DRAWING LOOP
-				while (draw_linestogo--)
+				level = maskrow[maskx];
+				for (runend = maskx + 1; runend < fademask->width && maskrow[runend] == level; ++runend)
+					;
+
+				x1 = wipe_scrxpos[maskx];
+				x2 = wipe_scrxpos[runend];
+				relativepos = (y * vid.width) + x1;
+
+				if (level == 0) // shortcut - memcpy source to work
+					M_Memcpy(w_base+relativepos, s_base+relativepos, x2-x1);
+				else if (level == 10) // shortcut - memcpy target to work
+					M_Memcpy(w_base+relativepos, e_base+relativepos, x2-x1);
+				else
 				{
+					// transtable that this mask level uses
+					transtbl = transtables + ((9 - level)<<FF_TRANSSHIFT);
 					w = w_base + relativepos;
 					s = s_base + relativepos;
 					e = e_base + relativepos;
-					draw_rowstogo = draw_rowend - draw_rowstart;
-
-					while (draw_rowstogo--)
+					for (x = x1; x < x2; x++)
 						*w++ = transtbl[ ( *e++ << 8 ) + *s++ ];
-
-					relativepos += vid.width;
 				}
-				// END DRAWING LOOP
 			}
-
-			if (++maskx >= fademask->width)
-				++masky, maskx = 0;
-		} while (++mask < maskend);
-
-		free(scrxpos);
-		free(scrypos);
+		}
 	}
 }
 #endif
@@ -324,6 +305,38 @@ void F_WipeEndScreen(void)
 #endif
 }
 
+/** Draws one frame of a wipe from screen 3 to screen 4, for hudbench.
+  *
+  * \param	wipetype	fade mask set to use
+  * \param	wipeframe	frame of it to draw
+  * \return	false if there's no such frame, so nothing was drawn
+  */
+boolean F_WipeBenchFrame(UINT8 wipetype, UINT8 wipeframe)
+{
+#ifdef NOWIPE
+	(void)wipetype;
+	(void)wipeframe;
+	return false;
+#else
+	fademask_t *fmask;
+
+	if (rendermode != render_soft)
+		return false;
+
+	paldiv = FixedDiv(257<<FRACBITS, 11<<FRACBITS);
+	wipe_scr = screens[0];
+	wipe_scr_start = screens[3];
+	wipe_scr_end = screens[4];
+
+	fmask = F_GetFadeMask(wipetype, wipeframe);
+	if (!fmask)
+		return false;
+
+	F_DoWipe(fmask);
+	return true;
+#endif
+}
+
 /** After setting up the screens you want to wipe,
   * calling this will do a 'typical' wipe.
   */
@@ -3487,10 +3487,10 @@ static void HWR_Subsector(size_t num)
 	{
 		if (gr_frontsector->moved)
 		{
-			gr_frontsector->numlights = sub->sector->numlights = 0;
 			R_Prep3DFloors(gr_frontsector);
 			sub->sector->lightlist = gr_frontsector->lightlist;
 			sub->sector->numlights = gr_frontsector->numlights;
+			sub->sector->maxlights = gr_frontsector->maxlights;
 			sub->sector->moved = gr_frontsector->moved = false;
 		}
 
@@ -4900,66 +4900,53 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 // --------------------------------------------------------------------------
 static gr_vissprite_t gr_vsprsortedhead;
 
+// Scratch space for HWR_SortVisSprites
+static gr_vissprite_t *gr_vsprsortbuf[MAXVISSPRITES], *gr_vsprsorttemp[MAXVISSPRITES];
+
+// Draw order: farthest first, and for the same distance, smallest dispoffset first
+// (neither nearer nor farther is the same distance, without comparing floats for equality)
+#define GR_VSPRBEFORE(a, b) ((a)->tz > (b)->tz || (!((a)->tz < (b)->tz) && (a)->dispoffset < (b)->dispoffset))
+
 static void HWR_SortVisSprites(void)
 {
-	UINT32 i;
-	gr_vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
-	gr_vissprite_t *best = NULL;
-	gr_vissprite_t unsorted;
-	float bestdist = 0.0f;
-	INT32 bestdispoffset = 0;
+	UINT32 i, width, lo, mid, hi, l, r, k;
+	gr_vissprite_t **src = gr_vsprsortbuf, **dst = gr_vsprsorttemp, **swap;
+	gr_vissprite_t *ds, *best;
 
 	if (!gr_visspritecount)
 		return;
 
-	dsfirst = HWR_GetVisSprite(0);
+	for (i = 0; i < gr_visspritecount; i++)
+		src[i] = HWR_GetVisSprite(i);
 
-	for (i = 0, dsnext = dsfirst, ds = NULL; i < gr_visspritecount; i++)
+	// Bottom-up merge sort. Ties keep the order the sprites were
+	// projected in, same as the old selection sort did.
+	for (width = 1; width < gr_visspritecount; width <<= 1)
 	{
-		dsprev = ds;
-		ds = dsnext;
-		if (i < gr_visspritecount - 1) dsnext = HWR_GetVisSprite(i + 1);
-
-		ds->next = dsnext;
-		ds->prev = dsprev;
+		for (lo = 0; lo < gr_visspritecount; lo += width<<1)
+		{
+			mid = min(lo + width, gr_visspritecount);
+			hi = min(lo + (width<<1), gr_visspritecount);
+			for (l = lo, r = mid, k = lo; k < hi; k++)
+			{
+				if (l < mid && (r >= hi || !GR_VSPRBEFORE(src[r], src[l])))
+					dst[k] = src[l++];
+				else
+					dst[k] = src[r++];
+			}
+		}
+		swap = src;
+		src = dst;
+		dst = swap;
 	}
 
-	// Fix first and last. ds still points to the last one after the loop
-	dsfirst->prev = &unsorted;
-	unsorted.next = dsfirst;
-	if (ds)
-		ds->next = &unsorted;
-	unsorted.prev = ds;
-
-	// pull the vissprites out by scale
 	gr_vsprsortedhead.next = gr_vsprsortedhead.prev = &gr_vsprsortedhead;
 	for (i = 0; i < gr_visspritecount; i++)
 	{
-		best = NULL;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
-		{
-			if (!best || ds->tz > bestdist)
-			{
-				bestdist = ds->tz;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-			// order visprites of same scale by dispoffset, smallest first
-			else if (fabsf(ds->tz - bestdist) < 1.0E-36f && ds->dispoffset < bestdispoffset)
-			{
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-		}
-		if (best)
-		{
-			best->next->prev = best->prev;
-			best->prev->next = best->next;
-			best->next = &gr_vsprsortedhead;
-			best->prev = gr_vsprsortedhead.prev;
-		}
-		gr_vsprsortedhead.prev->next = best;
-		gr_vsprsortedhead.prev = best;
+		src[i]->next = &gr_vsprsortedhead;
+		src[i]->prev = gr_vsprsortedhead.prev;
+		gr_vsprsortedhead.prev->next = src[i];
+		gr_vsprsortedhead.prev = src[i];
 	}
 
 	// Sryder:	Oh boy, while it's nice having ALL the sprites sorted properly, it fails when we bring MD2's into the
@@ -4990,6 +4977,8 @@ static void HWR_SortVisSprites(void)
 	}
 }
 
+#undef GR_VSPRBEFORE
+
 // A drawnode is something that points to a 3D floor, 3D side, or masked
 // middle texture. This is used for sorting with sprites.
 typedef struct
@@ -198,6 +198,7 @@ void HU_LoadGraphics(void)
 		else
 			tny_font[i] = (patch_t *)W_CachePatchName(buffer, PU_HUDGFX);
 	}
+	V_FlushTextRuns(); // drawn with the old font
 
 	// cache the level title font for entire game execution
 	lt_font[0] = (patch_t *)W_CachePatchName("LTFNT039", PU_HUDGFX); /// \note fake start hack
@@ -46,6 +46,19 @@ UINT32 I_GetFreeMem(UINT32 *total);
 */
 tic_t I_GetTime(void);
 
+/**	\brief	Returns a high resolution timestamp, for profiling only.
+	Only differences between two calls mean anything.
+*/
+precise_t I_GetPreciseTime(void);
+
+/**	\brief	Converts a difference between two I_GetPreciseTime calls.
+
+	\param	d	difference between two timestamps
+
+	\return	the difference in microseconds
+*/
+int I_PreciseToMicros(precise_t d);
+
 /**	\brief	The I_Sleep function
 
 	\return	void
@@ -306,4 +319,15 @@ const char *I_ClipboardPaste(void);
 
 void I_RegisterSysCommands(void);
 
+/**	\brief	Calls func(index, userdata) for every index from 0 to count-1,
+	spreading the calls over worker threads where the port has them.
+
+	\param	count	number of calls to make
+	\param	func	function to call; must be safe to run on several threads at once
+	\param	userdata	passed to every call
+
+	\return	void, once every call has returned
+*/
+void I_RunParallel(INT32 count, void (*func)(INT32 index, void *userdata), void *userdata);
+
 #endif
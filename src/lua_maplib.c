@@ -1376,6 +1376,8 @@ static int slope_set(lua_State *L)
 		P_CalculateSlopeNormal(slope);
 		break;
 	}
+	// keep dynamic slopes recalculating from their sources next tic, as before
+	slope->sourceheights[0] = slope->sourceheights[1] = slope->sourceheights[2] = INT32_MIN;
 	return 0;
 }
 
@@ -500,6 +500,7 @@ void T_MoveElevator(elevator_t *elevator)
 			res = crushed;
 			elevator->sector->floorheight = oldfloor;
 			elevator->sector->ceilingheight = oldceiling;
+			P_FFloorHeightsChanged(elevator->sector);
 		}
 		else
 			res = res1;
@@ -565,6 +566,7 @@ void T_MoveElevator(elevator_t *elevator)
 			res = crushed;
 			elevator->sector->floorheight = oldfloor;
 			elevator->sector->ceilingheight = oldceiling;
+			P_FFloorHeightsChanged(elevator->sector);
 		}
 		else
 			res = res1;
@@ -704,6 +706,7 @@ void T_ContinuousFalling(levelspecthink_t *faller)
 		{
 			faller->sector->ceilingheight = faller->ceilingwasheight;
 			faller->sector->floorheight = faller->floorwasheight;
+			P_FFloorHeightsChanged(faller->sector);
 		}
 	}
 	else // Up
@@ -712,6 +715,7 @@ void T_ContinuousFalling(levelspecthink_t *faller)
 		{
 			faller->sector->ceilingheight = faller->ceilingwasheight;
 			faller->sector->floorheight = faller->floorwasheight;
+			P_FFloorHeightsChanged(faller->sector);
 		}
 	}
 
@@ -1086,6 +1090,7 @@ void T_StartCrumble(elevator_t *elevator)
 		elevator->sector->crumblestate = 1;
 		elevator->sector->ceilingheight = elevator->ceilingwasheight;
 		elevator->sector->floorheight = elevator->floorwasheight;
+		P_FFloorHeightsChanged(elevator->sector);
 		elevator->sector->floordata = NULL;
 		elevator->sector->ceilingdata = NULL;
 		elevator->sector->ceilspeed = 0;
@@ -1144,6 +1149,7 @@ void T_MarioBlock(levelspecthink_t *block)
 	{
 		block->sector->ceilingheight = block->ceilingwasheight;
 		block->sector->floorheight = block->floorwasheight;
+		P_FFloorHeightsChanged(block->sector);
 		P_RemoveThinker(&block->thinker);
 		block->sector->floordata = NULL;
 		block->sector->ceilingdata = NULL;
@@ -1391,6 +1397,7 @@ wegotit:
 		{
 			bridge->sector->floorheight = LOWCEILINGHEIGHT - (bridge->sector->ceilingheight - bridge->sector->floorheight);
 			bridge->sector->ceilingheight = LOWCEILINGHEIGHT;
+			P_FFloorHeightsChanged(bridge->sector);
 			bridge->sector->ceilspeed = 0;
 			bridge->sector->floorspeed = 0;
 			goto dorest;
@@ -1477,6 +1484,7 @@ wegotit:
 						{
 							sectors[i].ceilingheight = ORIGCEILINGHEIGHT - (interval*plusplusme);
 							sectors[i].floorheight = ORIGFLOORHEIGHT - (interval*plusplusme);
+							P_FFloorHeightsChanged(&sectors[i]);
 						}
 						else // Do the regular rise
 						{
@@ -1489,6 +1497,7 @@ wegotit:
 							{
 								bridge->sector->floorheight = ORIGCEILINGHEIGHT - (bridge->sector->ceilingheight - bridge->sector->floorheight);
 								bridge->sector->ceilingheight = ORIGCEILINGHEIGHT;
+								P_FFloorHeightsChanged(bridge->sector);
 								bridge->sector->ceilspeed = 0;
 								bridge->sector->floorspeed = 0;
 								continue;
@@ -1572,6 +1581,7 @@ wegotit:
 						{
 							sectors[i].ceilingheight = sourcesec->ceilingheight + (interval*plusplusme);
 							sectors[i].floorheight = sourcesec->floorheight + (interval*plusplusme);
+							P_FFloorHeightsChanged(&sectors[i]);
 						}
 						else // Do the regular rise
 						{
@@ -1584,6 +1594,7 @@ wegotit:
 							{
 								bridge->sector->floorheight = ORIGCEILINGHEIGHT - (bridge->sector->ceilingheight - bridge->sector->floorheight);
 								bridge->sector->ceilingheight = ORIGCEILINGHEIGHT;
+								P_FFloorHeightsChanged(bridge->sector);
 								bridge->sector->ceilspeed = 0;
 								bridge->sector->floorspeed = 0;
 								continue;
@@ -1668,6 +1679,7 @@ wegotit:
 				{
 					bridge->sector->floorheight = ORIGCEILINGHEIGHT - (bridge->sector->ceilingheight - bridge->sector->floorheight);
 					bridge->sector->ceilingheight = ORIGCEILINGHEIGHT;
+					P_FFloorHeightsChanged(bridge->sector);
 					bridge->sector->ceilspeed = 0;
 					bridge->sector->floorspeed = 0;
 					continue;
@@ -2424,6 +2436,7 @@ void T_RaiseSector(levelspecthink_t *raise)
 			{
 				raise->sector->floorheight = raise->vars[7] - (raise->sector->ceilingheight - raise->sector->floorheight);
 				raise->sector->ceilingheight = raise->vars[7];
+				P_FFloorHeightsChanged(raise->sector);
 				raise->sector->ceilspeed = 0;
 				raise->sector->floorspeed = 0;
 				return;
@@ -2439,6 +2452,7 @@ void T_RaiseSector(levelspecthink_t *raise)
 			{
 				raise->sector->floorheight = raise->vars[5] - (raise->sector->ceilingheight - raise->sector->floorheight);
 				raise->sector->ceilingheight = raise->vars[5];
+				P_FFloorHeightsChanged(raise->sector);
 				raise->sector->ceilspeed = 0;
 				raise->sector->floorspeed = 0;
 				return;
@@ -2459,6 +2473,7 @@ void T_RaiseSector(levelspecthink_t *raise)
 			{
 				raise->sector->floorheight = raise->vars[5] - (raise->sector->ceilingheight - raise->sector->floorheight);
 				raise->sector->ceilingheight = raise->vars[5];
+				P_FFloorHeightsChanged(raise->sector);
 				raise->sector->ceilspeed = 0;
 				raise->sector->floorspeed = 0;
 				return;
@@ -2473,6 +2488,7 @@ void T_RaiseSector(levelspecthink_t *raise)
 			{
 				raise->sector->floorheight = raise->vars[7] - (raise->sector->ceilingheight - raise->sector->floorheight);
 				raise->sector->ceilingheight = raise->vars[7];
+				P_FFloorHeightsChanged(raise->sector);
 				raise->sector->ceilspeed = 0;
 				raise->sector->floorspeed = 0;
 				return;
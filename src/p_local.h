@@ -350,6 +350,8 @@ extern INT32 bmapheight; // in mapblocks
 extern fixed_t bmaporgx;
 extern fixed_t bmaporgy; // origin of block map
 extern mobj_t **blocklinks; // for thing chains
+extern mobj_t **noblocklinks; // MF_NOBLOCKMAP things, by block
+extern mobj_t *offblocklinks; // things that are off the map
 
 //
 // P_INTER
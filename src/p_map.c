@@ -1255,7 +1255,7 @@ boolean P_CheckPosition(mobj_t *thing, fixed_t x, fixed_t y)
 	tmbbox[BOXRIGHT] = x + tmthing->radius;
 	tmbbox[BOXLEFT] = x - tmthing->radius;
 
-	newsubsec = R_PointInSubsector(x, y);
+	newsubsec = R_PointInSubsectorHint(x, y, thing->subsector);
 	ceilingline = blockingline = NULL;
 
 	// The base floor / ceiling is from the subsector
@@ -1540,7 +1540,7 @@ boolean P_CheckCameraPosition(fixed_t x, fixed_t y, camera_t *thiscam)
 	tmbbox[BOXRIGHT] = x + thiscam->radius;
 	tmbbox[BOXLEFT] = x - thiscam->radius;
 
-	newsubsec = R_PointInSubsector(x, y);
+	newsubsec = R_PointInSubsectorHint(x, y, thiscam->subsector);
 	ceilingline = blockingline = NULL;
 
 	mapcampointer = thiscam;
@@ -1712,7 +1712,7 @@ boolean P_CheckCameraPosition(fixed_t x, fixed_t y, camera_t *thiscam)
 //
 boolean P_TryCameraMove(fixed_t x, fixed_t y, camera_t *thiscam)
 {
-	subsector_t *s = R_PointInSubsector(x, y);
+	subsector_t *s = R_PointInSubsectorHint(x, y, thiscam->subsector);
 	boolean retval = true;
 	boolean itsatwodlevel = false;
 
@@ -3350,6 +3350,9 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 	nofit = false;
 	crushchange = crunch;
 
+	// The sector has just moved, so any 3D floors it controls have too.
+	P_FFloorHeightsChanged(sector);
+
 	// killough 4/4/98: scan list front-to-back until empty or exhausted,
 	// restarting from beginning after each thing is processed. Avoids
 	// crashes, and is sure to examine all things in the sector, and only
@@ -751,6 +751,18 @@ void P_LineOpening(line_t *linedef, mobj_t *mobj)
 // THING POSITION SETTING
 //
 
+//
+// P_UnsetOffBlockPosition
+// Takes a thing out of noblocklinks or offblocklinks, if it's in there.
+//
+static void P_UnsetOffBlockPosition(mobj_t *thing)
+{
+	mobj_t *obnext, **obprev = thing->obprev;
+	if (obprev && (*obprev = obnext = thing->obnext) != NULL)
+		obnext->obprev = obprev;
+	thing->obnext = NULL, thing->obprev = NULL;
+}
+
 //
 // P_UnsetThingPosition
 // Unlinks a thing from block map and sectors.
@@ -811,6 +823,8 @@ void P_UnsetThingPosition(mobj_t *thing)
 		if (bprev && (*bprev = bnext = thing->bnext) != NULL)  // unlink from block map
 			bnext->bprev = bprev;
 	}
+
+	P_UnsetOffBlockPosition(thing);
 }
 
 void P_UnsetPrecipThingPosition(precipmobj_t *thing)
@@ -842,7 +856,7 @@ void P_SetThingPosition(mobj_t *thing)
 	if (thing->player && thing->z <= thing->floorz && thing->subsector)
 		oldsec = thing->subsector->sector;
 
-	ss = thing->subsector = R_PointInSubsector(thing->x, thing->y);
+	ss = thing->subsector = R_PointInSubsectorHint(thing->x, thing->y, thing->subsector);
 
 	if (!(thing->flags & MF_NOSECTOR))
 	{
@@ -900,6 +914,28 @@ void P_SetThingPosition(mobj_t *thing)
 			thing->bnext = NULL, thing->bprev = NULL;
 	}
 
+	// Things that didn't make it into a block are still kept track of, for
+	// P_RadiusThingsIterator: MF_NOBLOCKMAP ones by block in noblocklinks,
+	// and the few that are off the map in offblocklinks.
+	P_UnsetOffBlockPosition(thing);
+	if ((thing->flags & MF_NOBLOCKMAP) || !thing->bprev)
+	{
+		const INT32 blockx = (unsigned)(thing->x - bmaporgx)>>MAPBLOCKSHIFT;
+		const INT32 blocky = (unsigned)(thing->y - bmaporgy)>>MAPBLOCKSHIFT;
+		mobj_t **link = &offblocklinks;
+		mobj_t *obnext;
+
+		if (blockx >= 0 && blockx < bmapwidth
+			&& blocky >= 0 && blocky < bmapheight)
+			link = &noblocklinks[blocky*bmapwidth + blockx];
+
+		obnext = *link;
+		if ((thing->obnext = obnext) != NULL)
+			obnext->obprev = &thing->obnext;
+		thing->obprev = link;
+		*link = thing;
+	}
+
 	// Allows you to 'step' on a new linedef exec when the previous
 	// sector's floor is the same height.
 	if (thing->player && oldsec != NULL && thing->subsector && oldsec != thing->subsector->sector)
@@ -929,7 +965,7 @@ void P_SetUnderlayPosition(mobj_t *thing)
 	mobj_t **link, *lend;
 	I_Assert(thing);
 
-	ss = thing->subsector = R_PointInSubsector(thing->x, thing->y);
+	ss = thing->subsector = R_PointInSubsectorHint(thing->x, thing->y, thing->subsector);
 	link = &ss->sector->thinglist;
 	for (lend = *link; lend && lend->snext; lend = lend->snext)
 		;
@@ -952,7 +988,7 @@ void P_SetUnderlayPosition(mobj_t *thing)
 
 void P_SetPrecipitationThingPosition(precipmobj_t *thing)
 {
-	subsector_t *ss = thing->subsector = R_PointInSubsector(thing->x, thing->y);
+	subsector_t *ss = thing->subsector = R_PointInSubsectorHint(thing->x, thing->y, thing->subsector);
 
 	precipmobj_t **link = &ss->sector->preciplist;
 	precipmobj_t *snext = *link;
@@ -1068,6 +1104,128 @@ boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean (*func)(mobj_t *))
 	return true;
 }
 
+//
+// P_RadiusThingsIterator
+//
+// Calls func for every mobj on the thinker list whose center is within
+// range of (x, y) on both axes, in the same order a walk of the thinker
+// list would visit them. Candidates come from the blockmap, plus
+// noblocklinks for MF_NOBLOCKMAP things in the same blocks, and
+// offblocklinks for things that are off the map.
+// Mobjs spawned while func runs are visited afterwards, as they would be
+// at the end of the thinker list. func does its own exact range test.
+//
+static int P_CompareThinkerSerials(const void *p1, const void *p2)
+{
+	const UINT32 s1 = (*(mobj_t * const *)p1)->thinker.serial;
+	const UINT32 s2 = (*(mobj_t * const *)p2)->thinker.serial;
+
+	return (s1 < s2) ? -1 : (s1 > s2);
+}
+
+static boolean P_RadiusCandidate(mobj_t *mobj, fixed_t x, fixed_t y, fixed_t range)
+{
+	if ((INT64)mobj->x < (INT64)x - range || (INT64)mobj->x > (INT64)x + range
+		|| (INT64)mobj->y < (INT64)y - range || (INT64)mobj->y > (INT64)y + range)
+		return false;
+
+	// Not thinking (MF_NOTHINK) or already removed
+	return (mobj->thinker.next && mobj->thinker.function.acp1 == (actionf_p1)P_MobjThinker);
+}
+
+static mobj_t **P_AddRadiusCandidate(mobj_t **list, size_t *count, size_t *maxcount, mobj_t *mobj)
+{
+	if (*count == *maxcount)
+	{
+		*maxcount *= 2;
+		list = Z_Realloc(list, *maxcount * sizeof (*list), PU_STATIC, NULL);
+	}
+	list[(*count)++] = mobj;
+	return list;
+}
+
+boolean P_RadiusThingsIterator(fixed_t x, fixed_t y, fixed_t range, boolean (*func)(mobj_t *))
+{
+	INT64 xl, xh, yl, yh;
+	INT32 bx, by;
+	size_t i, j, count = 0, maxcount = 64;
+	mobj_t **list, *mobj;
+	thinker_t *th, *last;
+	boolean ret = true;
+
+	list = Z_Malloc(maxcount * sizeof (*list), PU_STATIC, NULL);
+
+	if (range >= 0)
+	{
+		xl = ((INT64)x - range - bmaporgx) >> MAPBLOCKSHIFT;
+		xh = ((INT64)x + range - bmaporgx) >> MAPBLOCKSHIFT;
+		yl = ((INT64)y - range - bmaporgy) >> MAPBLOCKSHIFT;
+		yh = ((INT64)y + range - bmaporgy) >> MAPBLOCKSHIFT;
+
+		if (xl < 0)
+			xl = 0;
+		if (yl < 0)
+			yl = 0;
+		if (xh >= bmapwidth)
+			xh = bmapwidth - 1;
+		if (yh >= bmapheight)
+			yh = bmapheight - 1;
+
+		for (by = (INT32)yl; by <= yh; by++)
+			for (bx = (INT32)xl; bx <= xh; bx++)
+			{
+				for (mobj = blocklinks[by*bmapwidth + bx]; mobj; mobj = mobj->bnext)
+					if (P_RadiusCandidate(mobj, x, y, range))
+						list = P_AddRadiusCandidate(list, &count, &maxcount, mobj);
+				for (mobj = noblocklinks[by*bmapwidth + bx]; mobj; mobj = mobj->obnext)
+					if (P_RadiusCandidate(mobj, x, y, range))
+						list = P_AddRadiusCandidate(list, &count, &maxcount, mobj);
+			}
+
+		for (mobj = offblocklinks; mobj; mobj = mobj->obnext)
+			if (P_RadiusCandidate(mobj, x, y, range))
+				list = P_AddRadiusCandidate(list, &count, &maxcount, mobj);
+
+		qsort(list, count, sizeof (*list), P_CompareThinkerSerials);
+
+		// A thing that got MF_NOBLOCKMAP without being unlinked first is
+		// still in its old block, so it can turn up twice.
+		for (i = j = 0; i < count; i++)
+			if (!j || list[i] != list[j-1])
+				list[j++] = list[i];
+		count = j;
+	}
+
+	last = thinkercap.prev;
+
+	for (i = 0; i < count; i++)
+	{
+		if (P_MobjWasRemoved(list[i]))
+			continue;
+		if (!func(list[i]))
+		{
+			ret = false;
+			break;
+		}
+	}
+
+	// Anything func spawned
+	if (ret)
+		for (th = last->next; th != &thinkercap; th = th->next)
+		{
+			if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+				continue;
+			if (!func((mobj_t *)th))
+			{
+				ret = false;
+				break;
+			}
+		}
+
+	Z_Free(list);
+	return ret;
+}
+
 //
 // INTERCEPT ROUTINES
 //
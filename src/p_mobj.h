@@ -307,6 +307,9 @@ typedef struct mobj_s
 	// Links in blocks (if needed).
 	struct mobj_s *bnext;
 	struct mobj_s **bprev; // killough 8/11/98: change to ptr-to-ptr
+	// Links in noblocklinks or offblocklinks, for things that are in no block.
+	struct mobj_s *obnext;
+	struct mobj_s **obprev;
 
 	// Additional pointers for NiGHTS hoops
 	struct mobj_s *hnext;
@@ -363,6 +366,11 @@ typedef struct mobj_s
 	struct pslope_s *standingslope; // The slope that the object is standing on (shouldn't need synced in savegames, right?)
 #endif
 
+	// Where this was at the start of the tic, for drawing between tics (see r_fps.c).
+	// Never read by game logic, so not saved.
+	fixed_t old_x, old_y, old_z;
+	angle_t old_angle;
+
 	// WARNING: New fields must be added separately to savegame and Lua.
 } mobj_t;
 
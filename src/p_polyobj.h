@@ -102,6 +102,11 @@ typedef struct polyobj_s
 
 	struct visplane_s *visplane; // polyobject's visplane, for ease of putting into the list later
 
+	// the view, and two of the vertices, the segs were last sorted for
+	fixed_t segsortx, segsorty;
+	angle_t segsortangle;
+	fixed_t segsortverts[4];
+
 	// these are saved for netgames, so do not let Lua touch these!
 	INT32 spawnflags; // Flags the polyobject originally spawned with
 } polyobj_t;
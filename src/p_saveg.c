@@ -27,6 +27,7 @@
 #include "y_inter.h"
 #include "z_zone.h"
 #include "r_main.h"
+#include "r_fps.h"
 #include "r_sky.h"
 #include "p_polyobj.h"
 #include "lua_script.h"
@@ -769,6 +770,8 @@ static void P_NetUnArchiveWorld(void)
 			sectors[i].floorheight = READFIXED(get);
 		if (diff & SD_CEILHT)
 			sectors[i].ceilingheight = READFIXED(get);
+		if (diff & (SD_FLOORHT|SD_CEILHT))
+			P_FFloorHeightsChanged(&sectors[i]);
 		if (diff & SD_FLOORPIC)
 		{
 			sectors[i].floorpic = P_AddLevelFlatRuntime((char *)get);
@@ -3406,6 +3409,7 @@ boolean P_LoadNetGame(void)
 		P_NetUnArchiveSpecials();
 		P_RelinkPointers();
 		P_FinishMobjs();
+		R_SaveInterpolationState();
 	}
 #ifdef HAVE_BLUA
 	LUA_UnArchive();
@@ -46,6 +46,7 @@
 
 #include "dehacked.h" // for map headers
 #include "r_main.h"
+#include "r_fps.h"
 #include "m_cond.h" // for emblems
 
 #include "m_argv.h"
@@ -119,6 +120,8 @@ INT32 *blockmaplump; // Big blockmap
 fixed_t bmaporgx, bmaporgy;
 // for thing chains
 mobj_t **blocklinks;
+mobj_t **noblocklinks;
+mobj_t *offblocklinks;
 
 // REJECT
 // For fast sight rejection.
@@ -711,7 +714,7 @@ static void P_LoadRawSectors(UINT8 *data, size_t i)
 		ss->crumblestate = 0;
 		ss->ffloors = NULL;
 		ss->lightlist = NULL;
-		ss->numlights = 0;
+		ss->numlights = ss->maxlights = 0;
 		ss->attached = NULL;
 		ss->attachedsolid = NULL;
 		ss->numattached = 0;
@@ -1891,6 +1894,8 @@ static void P_CreateBlockMap(void)
 		size_t count = sizeof (*blocklinks) * bmapwidth * bmapheight;
 		// clear out mobj chains (copied from from P_LoadBlockMap)
 		blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+		noblocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+		offblocklinks = NULL;
 		blockmap = blockmaplump + 4;
 
 #ifdef POLYOBJECTS
@@ -1968,6 +1973,8 @@ static boolean P_LoadBlockMap(lumpnum_t lumpnum)
 	// clear out mobj chains
 	count = sizeof (*blocklinks)* bmapwidth*bmapheight;
 	blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	noblocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	offblocklinks = NULL;
 	blockmap = blockmaplump+4;
 
 #ifdef POLYOBJECTS
@@ -2034,6 +2041,8 @@ static boolean P_LoadRawBlockMap(UINT8 *data, size_t count, const char *lumpname
 	// clear out mobj chains
 	count = sizeof (*blocklinks)* bmapwidth*bmapheight;
 	blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	noblocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	offblocklinks = NULL;
 	blockmap = blockmaplump+4;
 
 #ifdef POLYOBJECTS
@@ -2821,9 +2830,6 @@ boolean P_SetupLevel(boolean skipprecip)
 		Z_Free(ss->attachedsolid);
 	}
 
-	// Clear pointers that would be left dangling by the purge
-	R_FlushTranslationColormapCache();
-
 	Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
 
 #if defined (WALLSPLATS) || defined (FLOORSPLATS)
@@ -2946,6 +2952,8 @@ boolean P_SetupLevel(boolean skipprecip)
 		P_PrepareThings(lastloadedmaplumpnum + ML_THINGS);
 	}
 
+	R_BuildSubsectorHints();
+
 #ifdef ESLOPE
 	P_ResetDynamicSlopes();
 #endif
@@ -3138,6 +3146,10 @@ boolean P_SetupLevel(boolean skipprecip)
 	if (precache || dedicated)
 		R_PrecacheLevel();
 
+	// for either renderer
+	if (precache && !dedicated)
+		R_PrecacheTranslationColormaps();
+
 	nextmapoverride = 0;
 	skipstats = false;
 
@@ -3163,7 +3175,7 @@ boolean P_SetupLevel(boolean skipprecip)
 		savedata.lives = 0;
 	}
 
-	skyVisible = skyVisible1 = skyVisible2 = true; // assume the skybox is visible on level load.
+	skyVisible = viewcontexts[0].skyvisible = viewcontexts[1].skyvisible = true; // assume the skybox is visible on level load.
 	if (loadprecip) // uglier hack
 	{ // to make a newly loaded level start on the second frame.
 		INT32 buf = gametic % BACKUPTICS;
@@ -3178,6 +3190,8 @@ boolean P_SetupLevel(boolean skipprecip)
 #endif
 	}
 
+	R_SaveInterpolationState(); // nothing to slide in from
+
 	return true;
 }
 
@@ -94,32 +94,41 @@ static void P_ReconfigureVertexSlope(pslope_t *slope)
 	}
 }
 
+// Dynamic slope counters, see Command_SlopeStats_f
+static struct
+{
+	UINT32 checked;
+	UINT32 recalculated;
+} slopestats;
+
 // Recalculate dynamic slopes
 void P_RunDynamicSlopes(void) {
 	pslope_t *slope;
 
 	for (slope = slopelist; slope; slope = slope->next) {
-		fixed_t zdelta;
+		fixed_t zdelta, refheight, otherheight;
 
 		if (slope->flags & SL_NODYNAMIC)
 			continue;
 
+		slopestats.checked++;
+
 		switch(slope->refpos) {
 		case 1: // front floor
-			zdelta = slope->sourceline->backsector->floorheight - slope->sourceline->frontsector->floorheight;
-			slope->o.z = slope->sourceline->frontsector->floorheight;
+			refheight = slope->sourceline->frontsector->floorheight;
+			otherheight = slope->sourceline->backsector->floorheight;
 			break;
 		case 2: // front ceiling
-			zdelta = slope->sourceline->backsector->ceilingheight - slope->sourceline->frontsector->ceilingheight;
-			slope->o.z = slope->sourceline->frontsector->ceilingheight;
+			refheight = slope->sourceline->frontsector->ceilingheight;
+			otherheight = slope->sourceline->backsector->ceilingheight;
 			break;
 		case 3: // back floor
-			zdelta = slope->sourceline->frontsector->floorheight - slope->sourceline->backsector->floorheight;
-			slope->o.z = slope->sourceline->backsector->floorheight;
+			refheight = slope->sourceline->backsector->floorheight;
+			otherheight = slope->sourceline->frontsector->floorheight;
 			break;
 		case 4: // back ceiling
-			zdelta = slope->sourceline->frontsector->ceilingheight - slope->sourceline->backsector->ceilingheight;
-			slope->o.z = slope->sourceline->backsector->ceilingheight;
+			refheight = slope->sourceline->backsector->ceilingheight;
+			otherheight = slope->sourceline->frontsector->ceilingheight;
 			break;
 		case 5: // vertices
 			{
@@ -127,6 +136,7 @@ void P_RunDynamicSlopes(void) {
 				size_t i;
 				INT32 l;
 				line_t *line;
+				boolean moved = false;
 
 				for (i = 0; i < 3; i++) {
 					mt = slope->vertices[i];
@@ -135,9 +145,18 @@ void P_RunDynamicSlopes(void) {
 						line = &lines[l];
 						mt->z = line->frontsector->floorheight >> FRACBITS;
 					}
+					// Vertices can be shared between slopes, so compare
+					// against what this slope last used, not the old mt->z
+					if (slope->sourceheights[i] != mt->z) {
+						slope->sourceheights[i] = mt->z;
+						moved = true;
+					}
 				}
 
-				P_ReconfigureVertexSlope(slope);
+				if (moved) {
+					P_ReconfigureVertexSlope(slope);
+					slopestats.recalculated++;
+				}
 			}
 			continue; // TODO
 
@@ -145,14 +164,43 @@ void P_RunDynamicSlopes(void) {
 			I_Error("P_RunDynamicSlopes: slope has invalid type!");
 		}
 
+		// Nothing this slope depends on has moved since last tic
+		if (refheight == slope->sourceheights[0] && otherheight == slope->sourceheights[1])
+			continue;
+
+		slope->sourceheights[0] = refheight;
+		slope->sourceheights[1] = otherheight;
+		slope->o.z = refheight;
+		zdelta = otherheight - refheight;
+
 		if (slope->zdelta != FixedDiv(zdelta, slope->extent)) {
 			slope->zdelta = FixedDiv(zdelta, slope->extent);
 			slope->zangle = R_PointToAngle2(0, 0, slope->extent, -zdelta);
 			P_CalculateSlopeNormal(slope);
+			slopestats.recalculated++;
 		}
 	}
 }
 
+//
+// Command_SlopeStats_f
+//
+// Shows how many dynamic slope checks actually had to recalculate the slope.
+//
+void Command_SlopeStats_f(void)
+{
+	if (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"))
+	{
+		memset(&slopestats, 0, sizeof (slopestats));
+		return;
+	}
+
+	CONS_Printf(M_GetText("Dynamic slope checks : %10u\n"), slopestats.checked);
+	if (!slopestats.checked)
+		return;
+	CONS_Printf(M_GetText("Recalculated         : %10u (%u%%)\n"), slopestats.recalculated, (UINT32)((UINT64)slopestats.recalculated*100/slopestats.checked));
+}
+
 //
 // P_MakeSlope
 //
@@ -175,6 +223,9 @@ static pslope_t *P_MakeSlope(const vector3_t *o, const vector2_t *d,
 
 	ret->flags = flags;
 
+	// Make sure the first P_RunDynamicSlopes call picks up the source heights
+	ret->sourceheights[0] = ret->sourceheights[1] = ret->sourceheights[2] = INT32_MIN;
+
 	// Add to the slope list
 	ret->next = slopelist;
 	slopelist = ret;
@@ -564,6 +615,7 @@ static pslope_t *P_NewVertexSlope(INT16 tag1, INT16 tag2, INT16 tag3, UINT8 flag
 
 	P_ReconfigureVertexSlope(ret);
 	ret->refpos = 5;
+	ret->sourceheights[0] = ret->sourceheights[1] = ret->sourceheights[2] = INT32_MIN;
 
 	// Add to the slope list
 	ret->next = slopelist;
@@ -614,6 +614,32 @@ void P_SetupLevelFlatAnims(void)
 	}
 }
 
+/** Marks every frame of each texture animation the level uses, so that
+  * R_PrecacheLevel builds them all instead of one per frame mid-level.
+  *
+  * \param texturepresent One flag per texture, set for those in use.
+  * \sa P_InitPicAnims, R_PrecacheLevel
+  */
+void P_MarkAnimatedTextures(char *texturepresent)
+{
+	INT32 i, j;
+
+	for (i = 0; anims[i].istexture != -1; i++)
+	{
+		if (!anims[i].istexture)
+			continue;
+
+		for (j = 0; j < anims[i].numpics; j++)
+			if (texturepresent[anims[i].basepic + j])
+				break;
+		if (j == anims[i].numpics)
+			continue;
+
+		for (j = 0; j < anims[i].numpics; j++)
+			texturepresent[anims[i].basepic + j] = 1;
+	}
+}
+
 //
 // UTILITIES
 //
@@ -4454,13 +4480,15 @@ sector_t *P_ThingOnSpecial3DFloor(mobj_t *mo)
 {
 	sector_t *sector;
 	ffloor_t *rover;
+	ffloorquery_t query;
 	fixed_t topheight, bottomheight;
 
 	sector = mo->subsector->sector;
 	if (!sector->ffloors)
 		return NULL;
 
-	for (rover = sector->ffloors; rover; rover = rover->next)
+	// Whether standing on it or inside it, the thing has to touch the 3D floor.
+	for (rover = P_FirstFFloorInRange(&query, sector, mo->z, mo->z + mo->height); rover; rover = P_NextFFloorInRange(&query))
 	{
 		if (!rover->master->frontsector->special)
 			continue;
@@ -4853,6 +4881,179 @@ void P_UpdateSpecials(void)
 	}
 }
 
+//
+// 3D FLOOR HEIGHT INDEX
+//
+// Each sector keeps its 3Dfloors sorted by bottom height, so code that only
+// cares about the 3Dfloors overlapping an object can binary search for them
+// instead of walking the whole list. The index is rebuilt the next time it
+// is used after a control sector moves.
+//
+
+// Below this many 3Dfloors, just walk the list.
+#define FFLOORINDEX_MIN 4
+
+/** Marks the height index and lightlist of every sector a control sector's
+  * 3Dfloors are in as out of date. Call this after changing a sector's floor
+  * or ceiling height.
+  *
+  * \param sec Sector whose heights changed.
+  * \sa P_FirstFFloorInRange
+  */
+void P_FFloorHeightsChanged(sector_t *sec)
+{
+	size_t i;
+
+	for (i = 0; i < sec->numattached; i++)
+		sectors[sec->attached[i]].ffloorsmoved = sectors[sec->attached[i]].moved = true;
+}
+
+static int P_CompareFFloorSpans(const void *p1, const void *p2)
+{
+	const ffloorspan_t *span1 = p1, *span2 = p2;
+
+	if (span1->bottomheight != span2->bottomheight)
+		return (span1->bottomheight < span2->bottomheight) ? -1 : 1;
+	return (span1->order < span2->order) ? -1 : 1;
+}
+
+static void P_BuildFFloorIndex(sector_t *sec)
+{
+	ffloor_t *rover;
+	ffloorspan_t *span;
+	fixed_t maxtop = INT32_MIN;
+	size_t i, count = 0;
+
+	for (rover = sec->ffloors; rover; rover = rover->next)
+		count++;
+
+	if (count > sec->maxffloorspans)
+	{
+		sec->maxffloorspans = count;
+		sec->ffloorspans = Z_Realloc(sec->ffloorspans, count * sizeof (*sec->ffloorspans), PU_LEVEL, NULL);
+	}
+
+	for (rover = sec->ffloors, span = sec->ffloorspans, i = 0; rover; rover = rover->next, span++, i++)
+	{
+		span->rover = rover;
+		span->order = i;
+		span->bottomheight = *rover->bottomheight;
+		span->topheight = *rover->topheight;
+#ifdef ESLOPE
+		// Sloped planes aren't at any one height, so always check them.
+		if (*rover->b_slope)
+			span->bottomheight = INT32_MIN;
+		if (*rover->t_slope)
+			span->topheight = INT32_MAX;
+#endif
+	}
+
+	qsort(sec->ffloorspans, count, sizeof (*sec->ffloorspans), P_CompareFFloorSpans);
+
+	for (i = 0, span = sec->ffloorspans; i < count; i++, span++)
+	{
+		if (span->topheight > maxtop)
+			maxtop = span->topheight;
+		span->maxtop = maxtop;
+	}
+
+	sec->numffloorspans = count;
+	sec->ffloorsmoved = false;
+}
+
+/** Starts going through the 3Dfloors of a sector that may reach into a
+  * height range, that is, whose top is at or above low and whose bottom is
+  * at or below high. They come in the same order as in the sector's ffloors
+  * list, so a loop over them behaves exactly like one over the whole list
+  * that skips everything outside the range.
+  *
+  * \param query Iterator to fill in.
+  * \param sec   Sector to look in.
+  * \param low   Bottom of the height range.
+  * \param high  Top of the height range.
+  * \return First 3Dfloor, or NULL if there are none.
+  * \sa P_NextFFloorInRange
+  */
+ffloor_t *P_FirstFFloorInRange(ffloorquery_t *query, sector_t *sec, fixed_t low, fixed_t high)
+{
+	const ffloorspan_t *spans;
+	size_t order[MAXFFLOORQUERY];
+	size_t lo, hi, mid;
+	INT32 i, j;
+
+	query->pos = 0;
+
+	if (!sec->ffloors)
+	{
+		query->count = 0;
+		return query->rover = NULL;
+	}
+
+	if (sec->ffloorsmoved || !sec->ffloorspans)
+		P_BuildFFloorIndex(sec);
+
+	if (sec->numffloorspans < FFLOORINDEX_MIN || high < low)
+	{
+		query->count = -1;
+		return query->rover = sec->ffloors;
+	}
+
+	// Find the first 3Dfloor whose bottom is above the range...
+	spans = sec->ffloorspans;
+	lo = 0;
+	hi = sec->numffloorspans;
+	while (lo < hi)
+	{
+		mid = (lo + hi)/2;
+		if (spans[mid].bottomheight <= high)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	// ...then go down from there until nothing can reach the range anymore.
+	query->count = 0;
+	for (i = (INT32)lo - 1; i >= 0 && spans[i].maxtop >= low; i--)
+	{
+		if (spans[i].topheight < low)
+			continue;
+
+		if (query->count == MAXFFLOORQUERY)
+		{
+			query->count = -1;
+			return query->rover = sec->ffloors;
+		}
+
+		// Keep the list in ffloors order.
+		for (j = query->count; j > 0 && spans[i].order < order[j-1]; j--)
+		{
+			query->list[j] = query->list[j-1];
+			order[j] = order[j-1];
+		}
+		query->list[j] = spans[i].rover;
+		order[j] = spans[i].order;
+		query->count++;
+	}
+
+	return query->rover = (query->count ? query->list[0] : NULL);
+}
+
+/** Continues going through 3Dfloors started by P_FirstFFloorInRange.
+  *
+  * \param query Iterator.
+  * \return Next 3Dfloor, or NULL if there are no more.
+  * \sa P_FirstFFloorInRange
+  */
+ffloor_t *P_NextFFloorInRange(ffloorquery_t *query)
+{
+	if (query->count == -1)
+		return query->rover = (query->rover ? query->rover->next : NULL);
+
+	if (++query->pos >= query->count)
+		return query->rover = NULL;
+	return query->rover = query->list[query->pos];
+}
+
 static inline ffloor_t *P_GetFFloorBySec(sector_t *sec, sector_t *sec2)
 {
 	ffloor_t *rover;
@@ -4875,6 +5076,8 @@ static inline void P_AddFFloorToList(sector_t *sec, ffloor_t *ffloor)
 {
 	ffloor_t *rover;
 
+	sec->ffloorsmoved = true;
+
 	if (!sec->ffloors)
 	{
 		sec->ffloors = ffloor;
@@ -4922,6 +5125,7 @@ static ffloor_t *P_AddFakeFloor(sector_t *sec, sector_t *sec2, line_t *master, f
 		CONS_Alert(CONS_ERROR, M_GetText("A FOF tagged %d has a top height below its bottom.\n"), master->tag);
 		sec2->ceilingheight = sec2->floorheight;
 		sec2->floorheight = tempceiling;
+		P_FFloorHeightsChanged(sec2);
 	}
 
 	sec2->tagline = master;
@@ -31,6 +31,9 @@ void P_InitPicAnims(void);
 // at map load (sectors)
 void P_SetupLevelFlatAnims(void);
 
+// at map load (textures to precache)
+void P_MarkAnimatedTextures(char *texturepresent);
+
 // at map load
 void P_SpawnSpecials(INT32 fromnetsave);
 
@@ -452,4 +455,19 @@ void P_CalcHeight(player_t *player);
 
 sector_t *P_ThingOnSpecial3DFloor(mobj_t *mo);
 
+// 3D floor height index
+#define MAXFFLOORQUERY 32
+
+typedef struct
+{
+	ffloor_t *list[MAXFFLOORQUERY];
+	INT32 count; // -1 when walking the sector's whole ffloors list instead
+	INT32 pos;
+	ffloor_t *rover;
+} ffloorquery_t;
+
+void P_FFloorHeightsChanged(sector_t *sec);
+ffloor_t *P_FirstFFloorInRange(ffloorquery_t *query, sector_t *sec, fixed_t low, fixed_t high);
+ffloor_t *P_NextFFloorInRange(ffloorquery_t *query);
+
 #endif
@@ -19,6 +19,7 @@
 #include "st_stuff.h"
 #include "p_polyobj.h"
 #include "m_random.h"
+#include "r_fps.h"
 #include "lua_script.h"
 #include "lua_hook.h"
 
@@ -176,9 +177,12 @@ void Command_CountMobjs_f(void)
 //
 // P_InitThinkers
 //
+static UINT32 thinkerserial;
+
 void P_InitThinkers(void)
 {
 	thinkercap.prev = thinkercap.next = &thinkercap;
+	thinkerserial = 0;
 }
 
 //
@@ -193,6 +197,7 @@ void P_AddThinker(thinker_t *thinker)
 	thinkercap.prev = thinker;
 
 	thinker->references = 0;    // killough 11/98: init reference counter to 0
+	thinker->serial = thinkerserial++;
 }
 
 //
@@ -569,6 +574,10 @@ void P_Ticker(boolean run)
 {
 	INT32 i;
 
+	// Where everything starts this tic, for frames drawn in between.
+	// Done even when paused, so the view holds still.
+	R_SaveInterpolationState();
+
 	//Increment jointime even if paused.
 	for (i = 0; i < MAXPLAYERS; i++)
 		if (playeringame[i])
@@ -3857,47 +3857,59 @@ void P_DoJumpShield(player_t *player)
 // Morph's fancy stuff-moving character ability
 // +ve thrust pushes away, -ve thrust pulls in
 //
-void P_Telekinesis(player_t *player, fixed_t thrust, fixed_t range)
+static player_t *telekinesisplayer;
+static fixed_t telekinesisthrust, telekinesisrange;
+
+static boolean PIT_Telekinesis(mobj_t *mo2)
 {
-	thinker_t *th;
-	mobj_t *mo2;
-	fixed_t dist = 0;
+	player_t *player = telekinesisplayer;
+	fixed_t dist;
 	angle_t an;
 
-	if (player->powers[pw_super]) // increase range when super
-		range *= 2;
+	if (mo2 == player->mo)
+		return true;
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
-	{
-		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue;
+	if (!((mo2->flags & MF_SHOOTABLE && mo2->flags & MF_ENEMY) || mo2->type == MT_EGGGUARD || mo2->player))
+		return true;
 
-		mo2 = (mobj_t *)th;
+	dist = P_AproxDistance(P_AproxDistance(player->mo->x-mo2->x, player->mo->y-mo2->y), player->mo->z-mo2->z);
 
-		if (mo2 == player->mo)
-			continue;
+	if (telekinesisrange < dist)
+		return true;
 
-		if (!((mo2->flags & MF_SHOOTABLE && mo2->flags & MF_ENEMY) || mo2->type == MT_EGGGUARD || mo2->player))
-			continue;
+	if (!P_CheckSight(player->mo, mo2))
+		return true; // if your psychic powers can't "see" it don't bother
 
-		dist = P_AproxDistance(P_AproxDistance(player->mo->x-mo2->x, player->mo->y-mo2->y), player->mo->z-mo2->z);
+	an = R_PointToAngle2(player->mo->x, player->mo->y, mo2->x, mo2->y);
 
-		if (range < dist)
-			continue;
+	if (mo2->health > 0)
+	{
+		P_Thrust(mo2, an, telekinesisthrust);
 
-		if (!P_CheckSight(player->mo, mo2))
-			continue; // if your psychic powers can't "see" it don't bother
+		if (mo2->type == MT_GOLDBUZZ || mo2->type == MT_REDBUZZ)
+			mo2->tics += 8;
+	}
 
-		an = R_PointToAngle2(player->mo->x, player->mo->y, mo2->x, mo2->y);
+	return true;
+}
 
-		if (mo2->health > 0)
-		{
-			P_Thrust(mo2, an, thrust);
+void P_Telekinesis(player_t *player, fixed_t thrust, fixed_t range)
+{
+	player_t *oldplayer = telekinesisplayer;
+	fixed_t oldthrust = telekinesisthrust, oldrange = telekinesisrange;
 
-			if (mo2->type == MT_GOLDBUZZ || mo2->type == MT_REDBUZZ)
-				mo2->tics += 8;
-		}
-	}
+	if (player->powers[pw_super]) // increase range when super
+		range *= 2;
+
+	telekinesisplayer = player;
+	telekinesisthrust = thrust;
+	telekinesisrange = range;
+	P_RadiusThingsIterator(player->mo->x, player->mo->y, range, PIT_Telekinesis);
+
+	// In case a hook called us again from inside the iterator
+	telekinesisplayer = oldplayer;
+	telekinesisthrust = oldthrust;
+	telekinesisrange = oldrange;
 
 	P_SpawnThokMobj(player);
 	player->pflags |= PF_THOKKED;
@@ -7410,12 +7422,50 @@ static void P_NukeAllPlayers(player_t *player)
 // P_NukeEnemies
 // Looks for something you can hit - Used for bomb shield
 //
+static mobj_t *nukeinflictor, *nukesource;
+static fixed_t nukeradius;
+
+static boolean PIT_NukeEnemies(mobj_t *mo)
+{
+	mobj_t *inflictor = nukeinflictor;
+	const fixed_t radius = nukeradius;
+
+	if (!(mo->flags & MF_SHOOTABLE) && !(mo->type == MT_EGGGUARD || mo->type == MT_MINUS))
+		return true;
+
+	if (mo->flags & MF_MONITOR)
+		return true; // Monitors cannot be 'nuked'.
+
+	if (!G_RingSlingerGametype() && mo->type == MT_PLAYER)
+		return true; // Don't hurt players in Co-Op!
+
+	if (abs(inflictor->x - mo->x) > radius || abs(inflictor->y - mo->y) > radius || abs(inflictor->z - mo->z) > radius)
+		return true; // Workaround for possible integer overflow in the below -Red
+
+	if (P_AproxDistance(P_AproxDistance(inflictor->x - mo->x, inflictor->y - mo->y), inflictor->z - mo->z) > radius)
+		return true;
+
+	if (mo->type == MT_MINUS && !(mo->flags & (MF_SPECIAL|MF_SHOOTABLE)))
+		mo->flags |= MF_SPECIAL|MF_SHOOTABLE;
+
+	if (mo->type == MT_EGGGUARD && mo->tracer) //nuke Egg Guard's shield!
+		P_KillMobj(mo->tracer, inflictor, nukesource);
+
+	if (mo->flags & MF_BOSS || mo->type == MT_PLAYER) //don't OHKO bosses nor players!
+		P_DamageMobj(mo, inflictor, nukesource, 1);
+	else
+		P_DamageMobj(mo, inflictor, nukesource, 1000);
+
+	return true;
+}
+
 void P_NukeEnemies(mobj_t *inflictor, mobj_t *source, fixed_t radius)
 {
 	const fixed_t ns = 60 << FRACBITS;
 	mobj_t *mo;
+	mobj_t *oldinflictor = nukeinflictor, *oldsource = nukesource;
+	fixed_t oldradius = nukeradius;
 	angle_t fa;
-	thinker_t *think;
 	INT32 i;
 
 	for (i = 0; i < 16; i++)
@@ -7429,39 +7479,15 @@ void P_NukeEnemies(mobj_t *inflictor, mobj_t *source, fixed_t radius)
 		}
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
-	{
-		if (think->function.acp1 != (actionf_p1)P_MobjThinker)
-			continue; // not a mobj thinker
-
-		mo = (mobj_t *)think;
-
-		if (!(mo->flags & MF_SHOOTABLE) && !(mo->type == MT_EGGGUARD || mo->type == MT_MINUS))
-			continue;
-
-		if (mo->flags & MF_MONITOR)
-			continue; // Monitors cannot be 'nuked'.
+	nukeinflictor = inflictor;
+	nukesource = source;
+	nukeradius = radius;
+	P_RadiusThingsIterator(inflictor->x, inflictor->y, radius, PIT_NukeEnemies);
 
-		if (!G_RingSlingerGametype() && mo->type == MT_PLAYER)
-			continue; // Don't hurt players in Co-Op!
-
-		if (abs(inflictor->x - mo->x) > radius || abs(inflictor->y - mo->y) > radius || abs(inflictor->z - mo->z) > radius)
-			continue; // Workaround for possible integer overflow in the below -Red
-
-		if (P_AproxDistance(P_AproxDistance(inflictor->x - mo->x, inflictor->y - mo->y), inflictor->z - mo->z) > radius)
-			continue;
-
-		if (mo->type == MT_MINUS && !(mo->flags & (MF_SPECIAL|MF_SHOOTABLE)))
-			mo->flags |= MF_SPECIAL|MF_SHOOTABLE;
-
-		if (mo->type == MT_EGGGUARD && mo->tracer) //nuke Egg Guard's shield!
-			P_KillMobj(mo->tracer, inflictor, source);
-
-		if (mo->flags & MF_BOSS || mo->type == MT_PLAYER) //don't OHKO bosses nor players!
-			P_DamageMobj(mo, inflictor, source, 1);
-		else
-			P_DamageMobj(mo, inflictor, source, 1000);
-	}
+	// In case a hook called us again from inside the iterator
+	nukeinflictor = oldinflictor;
+	nukesource = oldsource;
+	nukeradius = oldradius;
 }
 
 //
@@ -7840,7 +7866,7 @@ void P_ResetCamera(player_t *player, camera_t *thiscam)
 	}
 	thiscam->relativex = 0;
 
-	thiscam->subsector = R_PointInSubsector(thiscam->x,thiscam->y);
+	thiscam->subsector = R_PointInSubsectorHint(thiscam->x, thiscam->y, thiscam->subsector);
 
 	thiscam->radius = 20*FRACUNIT;
 	thiscam->height = 16*FRACUNIT;
@@ -471,14 +471,14 @@ static void R_AddLine(seg_t *line)
 			INT32 line2 = P_FindSpecialLineFromTag(40, line->linedef->tag, -1);
 			if (line->linedef == &lines[line2])
 				line2 = P_FindSpecialLineFromTag(40, line->linedef->tag, line2);
-			if (line2 >= 0) // found it!
+			// found it! Remember the lines for later rendering, if it fits in the budget
+			if (line2 >= 0 && R_AddPortal(line->linedef-lines, line2, x1, x2))
 			{
-				R_AddPortal(line->linedef-lines, line2, x1, x2); // Remember the lines for later rendering
 				//return; // Don't fill in that space now!
 				goto clipsolid;
 			}
 		}
-		// Recursed TOO FAR (viewing a portal within a portal)
+		// Recursed TOO FAR (viewing a portal within a portal), or over budget
 		// So uhhh, render it as a normal wall instead or something ???
 	}
 
@@ -775,6 +775,92 @@ static int R_PolysegCompare(const void *p1, const void *p2)
 #undef pdist
 }
 
+//
+// R_PolysegDist
+//
+// The distance R_PolysegCompare sorts by first: how far the nearer end of
+// the seg is along the view direction.
+//
+static fixed_t R_PolysegDist(const seg_t *seg)
+{
+	fixed_t dist1, dist2;
+
+	dist1 = FixedMul(R_PointToDist(seg->v1->x, seg->v1->y), FINECOSINE((R_PointToAngle(seg->v1->x, seg->v1->y)-viewangle)>>ANGLETOFINESHIFT))+0xFFFFFFF;
+	dist2 = FixedMul(R_PointToDist(seg->v2->x, seg->v2->y), FINECOSINE((R_PointToAngle(seg->v2->x, seg->v2->y)-viewangle)>>ANGLETOFINESHIFT))+0xFFFFFFF;
+
+	return min(dist1, dist2);
+}
+
+static fixed_t *polysegdists;
+static size_t maxpolysegdists;
+
+//
+// R_SortPolysegs
+//
+// Puts a polyobject's segs in the order R_PolysegCompare wants. They're
+// only sorted again when the view or the polyobject has moved since the
+// last time, and then the last order is usually still right, or nearly,
+// so an insertion sort only has to move a few of them. Each seg's distance
+// is worked out once, rather than twice for every comparison.
+//
+static void R_SortPolysegs(polyobj_t *po)
+{
+	const vertex_t *first, *last;
+	seg_t *seg;
+	fixed_t dist;
+	size_t i, j;
+
+	if (po->segCount < 2 || !po->numVertices)
+		return;
+
+	first = po->vertices[0];
+	last = po->vertices[po->numVertices-1];
+	if (po->segsortx == viewx && po->segsorty == viewy && po->segsortangle == viewangle
+		&& po->segsortverts[0] == first->x && po->segsortverts[1] == first->y
+		&& po->segsortverts[2] == last->x && po->segsortverts[3] == last->y)
+		return;
+
+	po->segsortx = viewx;
+	po->segsorty = viewy;
+	po->segsortangle = viewangle;
+	po->segsortverts[0] = first->x;
+	po->segsortverts[1] = first->y;
+	po->segsortverts[2] = last->x;
+	po->segsortverts[3] = last->y;
+
+	if (po->segCount > maxpolysegdists)
+	{
+		maxpolysegdists = po->segCount*2;
+		polysegdists = Z_Realloc(polysegdists, maxpolysegdists * sizeof (*polysegdists), PU_STATIC, NULL);
+	}
+
+	for (i = 0; i < po->segCount; i++)
+		polysegdists[i] = R_PolysegDist(po->segs[i]);
+
+	for (i = 1; i < po->segCount; i++)
+	{
+		seg = po->segs[i];
+		dist = polysegdists[i];
+
+		for (j = i; j > 0; j--)
+		{
+			if (polysegdists[j-1] == dist)
+			{
+				if (R_PolysegCompare(&po->segs[j-1], &seg) <= 0)
+					break;
+			}
+			else if (polysegdists[j-1] - dist <= 0)
+				break;
+
+			po->segs[j] = po->segs[j-1];
+			polysegdists[j] = polysegdists[j-1];
+		}
+
+		po->segs[j] = seg;
+		polysegdists[j] = dist;
+	}
+}
+
 //
 // R_AddPolyObjects
 //
@@ -801,7 +887,7 @@ static void R_AddPolyObjects(subsector_t *sub)
 	// render polyobjects
 	for (i = 0; i < numpolys; ++i)
 	{
-		qsort(po_ptrs[i]->segs, po_ptrs[i]->segCount, sizeof(seg_t *), R_PolysegCompare);
+		R_SortPolysegs(po_ptrs[i]);
 		for (j = 0; j < po_ptrs[i]->segCount; ++j)
 			R_AddLine(po_ptrs[i]->segs[j]);
 	}
@@ -826,6 +912,7 @@ static void R_Subsector(size_t num)
 	extracolormap_t *floorcolormap;
 	extracolormap_t *ceilingcolormap;
 	fixed_t floorcenterz, ceilingcenterz;
+	precise_t timer;
 
 #ifdef RANGECHECK
 	if (num >= numsubsectors)
@@ -863,10 +950,10 @@ static void R_Subsector(size_t num)
 	{
 		if (frontsector->moved)
 		{
-			frontsector->numlights = sub->sector->numlights = 0;
 			R_Prep3DFloors(frontsector);
 			sub->sector->lightlist = frontsector->lightlist;
 			sub->sector->numlights = frontsector->numlights;
+			sub->sector->maxlights = frontsector->maxlights;
 			sub->sector->moved = frontsector->moved = false;
 		}
 
@@ -1173,7 +1260,9 @@ static void R_Subsector(size_t num)
    // Either you must pass the fake sector and handle validcount here, on the
    // real sector, or you must account for the lighting in some other way,
    // like passing it as an argument.
+	timer = R_StartTimer();
 	R_AddSprites(sub->sector, (floorlightlevel+ceilinglightlevel)/2);
+	R_LapTimer(timer, RT_SPRITES);
 
 	firstseg = NULL;
 
@@ -1193,6 +1282,7 @@ static void R_Subsector(size_t num)
 		line++;
 		curline = NULL; /* cph 2001/11/18 - must clear curline now we're done with it, so stuff doesn't try using it for other things */
 	}
+	R_LapTimer(timer, RT_SEGS);
 }
 
 //
@@ -1225,14 +1315,16 @@ void R_Prep3DFloors(sector_t *sector)
 		}
 	}
 
-	if (count != sector->numlights)
+	// Keep the old lightlist around and only grow it, so a moving sector
+	// doesn't go through the zone allocator every time it is rebuilt.
+	if (count > sector->maxlights)
 	{
 		Z_Free(sector->lightlist);
-		sector->lightlist = Z_Calloc(sizeof (*sector->lightlist) * count, PU_LEVEL, NULL);
-		sector->numlights = count;
+		sector->lightlist = Z_Malloc(sizeof (*sector->lightlist) * count, PU_LEVEL, NULL);
+		sector->maxlights = count;
 	}
-	else
-		memset(sector->lightlist, 0, sizeof (lightlist_t) * count);
+	sector->numlights = count;
+	memset(sector->lightlist, 0, sizeof (lightlist_t) * count);
 
 #ifdef ESLOPE
 	heighttest = sector->c_slope ? P_GetZAt(sector->c_slope, sector->soundorg.x, sector->soundorg.y) : sector->ceilingheight;
@@ -1371,6 +1463,16 @@ INT32 R_GetPlaneLight(sector_t *sector, fixed_t planeheight, boolean underside)
 	return sector->numlights - 1;
 }
 
+//
+// R_BehindPortal
+// While rendering a portal, everything on the back of the line it looks
+// out of is between the view and the portal, so none of it is drawn.
+//
+static boolean R_BehindPortal(fixed_t *bspcoord)
+{
+	return (portalrender && portalclipline && P_BoxOnLineSide(bspcoord, portalclipline) == 1);
+}
+
 //
 // RenderBSPNode
 // Renders all subsectors below a given node,
@@ -1390,11 +1492,12 @@ void R_RenderBSPNode(INT32 bspnum)
 		// Decide which side the view point is on.
 		side = R_PointOnSide(viewx, viewy, bsp);
 		// Recursively divide front space.
-		R_RenderBSPNode(bsp->children[side]);
+		if (!R_BehindPortal(bsp->bbox[side]))
+			R_RenderBSPNode(bsp->children[side]);
 
 		// Possibly divide back space.
 
-		if (!R_CheckBBox(bsp->bbox[side^1]))
+		if (!R_CheckBBox(bsp->bbox[side^1]) || R_BehindPortal(bsp->bbox[side^1]))
 			return;
 
 		bspnum = bsp->children[side^1];
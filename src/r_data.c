@@ -22,6 +22,7 @@
 #include "w_wad.h"
 #include "z_zone.h"
 #include "p_setup.h" // levelflats
+#include "i_system.h" // I_RunParallel
 #include "v_video.h" // pLocalPalette
 #include "dehacked.h"
 
@@ -174,26 +175,21 @@ static inline void R_DrawColumnInCache(column_t *patch, UINT8 *cache, INT32 orig
 }
 
 //
-// R_GenerateTexture
-//
-// Allocate space for full size texture, either single patch or 'composite'
-// Build the full textures from patches.
-// The texture caching system is a little more hungry of memory, but has
-// been simplified for the sake of highcolor, dynamic ligthing, & speed.
+// R_AllocateTexture
 //
-// This is not optimised, but it's supposed to be executed only once
-// per level, when enough memory is available.
+// Allocate space for full size texture, either single patch or 'composite'.
+// Single patches with holes are copied in whole and are finished here.
+// Otherwise, the column lookup is filled in and the block is returned, still
+// PU_STATIC, for R_CompositeTexture to draw the patches into.
 //
-static UINT8 *R_GenerateTexture(size_t texnum)
+static UINT8 *R_AllocateTexture(size_t texnum)
 {
 	UINT8 *block;
-	UINT8 *blocktex;
 	texture_t *texture;
 	texpatch_t *patch;
 	patch_t *realpatch;
-	int x, x1, x2, i;
+	int x;
 	size_t blocksize;
-	column_t *patchcol;
 	UINT32 *colofs;
 
 	I_Assert(texnum <= (size_t)numtextures);
@@ -248,10 +244,12 @@ static UINT8 *R_GenerateTexture(size_t texnum)
 			// use the patch's column lookup
 			colofs = (UINT32 *)(void *)(block + 8);
 			texturecolumnofs[texnum] = colofs;
-			blocktex = block;
 			for (x = 0; x < texture->width; x++)
 				colofs[x] = LONG(LONG(colofs[x]) + 3);
-			goto done;
+
+			// Now that the texture has been built in column cache, it is purgable from zone memory.
+			Z_ChangeTag(block, PU_CACHE);
+			return NULL;
 		}
 
 		// Otherwise, do multipatch format.
@@ -263,19 +261,39 @@ static UINT8 *R_GenerateTexture(size_t texnum)
 	texturememory += blocksize;
 	block = Z_Malloc(blocksize+1, PU_STATIC, &texturecache[texnum]);
 
-	memset(block, 0xF7, blocksize+1); // Transparency hack
-
-	// columns lookup table
+	// columns lookup table, with the texture data after it one whole
+	// column after another, so every column can be drawn straight from it
 	colofs = (UINT32 *)(void *)block;
 	texturecolumnofs[texnum] = colofs;
+	for (x = 0; x < texture->width; x++)
+		colofs[x] = LONG((x * texture->height) + (texture->width*4));
 
-	// texture data after the lookup table
-	blocktex = block + (texture->width*4);
+	return block;
+}
+
+//
+// R_CompositeTexture
+//
+// Composite the columns of a block from R_AllocateTexture together.
+// realpatches holds the texture's patches, already cached, when this is
+// run on a worker thread; otherwise it is NULL and they are cached here.
+//
+static void R_CompositeTexture(texture_t *texture, UINT8 *block, patch_t **realpatches)
+{
+	UINT8 *blocktex = block + (texture->width*4);
+	texpatch_t *patch;
+	patch_t *realpatch;
+	int x, x1, x2, i;
+	column_t *patchcol;
+
+	memset(blocktex, 0xF7, (texture->width * texture->height) + 1); // Transparency hack
 
-	// Composite the columns together.
 	for (i = 0, patch = texture->patches; i < texture->patchcount; i++, patch++)
 	{
-		realpatch = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_CACHE);
+		if (realpatches)
+			realpatch = realpatches[i];
+		else
+			realpatch = W_CacheLumpNumPwad(patch->wad, patch->lump, PU_CACHE);
 		x1 = patch->originx;
 		x2 = x1 + SHORT(realpatch->width);
 
@@ -290,17 +308,130 @@ static UINT8 *R_GenerateTexture(size_t texnum)
 		for (; x < x2; x++)
 		{
 			patchcol = (column_t *)((UINT8 *)realpatch + LONG(realpatch->columnofs[x-x1]));
+			R_DrawColumnInCache(patchcol, blocktex + (x * texture->height), patch->originy, texture->height);
+		}
+	}
+}
+
+//
+// R_GenerateTexture
+//
+// Build the full textures from patches.
+// The texture caching system is a little more hungry of memory, but has
+// been simplified for the sake of highcolor, dynamic ligthing, & speed.
+//
+// This is not optimised, but it's supposed to be executed only once
+// per level, when enough memory is available; R_PrecacheLevel builds
+// everything the level uses up front with R_GenerateTextures.
+//
+static UINT8 *R_GenerateTexture(size_t texnum)
+{
+	UINT8 *block = R_AllocateTexture(texnum);
+
+	if (block)
+	{
+		R_CompositeTexture(textures[texnum], block, NULL);
+
+		// Now that the texture has been built in column cache, it is purgable from zone memory.
+		Z_ChangeTag(block, PU_CACHE);
+	}
+
+	return texturecache[texnum];
+}
+
+// A composite texture waiting to be built by R_GenerateTextures
+typedef struct
+{
+	size_t texnum;
+	UINT8 *block;
+	patch_t **realpatches; // one per patch of the texture, kept PU_STATIC
+} texturejob_t;
+
+typedef struct
+{
+	texturejob_t *jobs;
+	INT32 numjobs, numthreads;
+} texturebatch_t;
+
+static void R_CompositeTextureJobs(INT32 index, void *userdata)
+{
+	texturebatch_t *batch = userdata;
+	INT32 i;
+
+	for (i = index; i < batch->numjobs; i += batch->numthreads)
+		R_CompositeTexture(textures[batch->jobs[i].texnum], batch->jobs[i].block, batch->jobs[i].realpatches);
+}
+
+//
+// R_GenerateTextures
+//
+// Builds every texture flagged in texturepresent that isn't cached already.
+// Memory and lump reads have to happen here, but the compositing itself
+// only touches the texture's own block, so it is shared out between
+// cv_renderthreads threads.
+// Returns how many textures needed compositing.
+//
+static INT32 R_GenerateTextures(const char *texturepresent, INT32 numthreads)
+{
+	texturebatch_t batch;
+	patch_t **realpatches;
+	size_t numpatches = 0;
+	INT32 i, j;
 
-			// generate column ofset lookup
-			colofs[x] = LONG((x * texture->height) + (texture->width*4));
-			R_DrawColumnInCache(patchcol, block + LONG(colofs[x]), patch->originy, texture->height);
+	batch.numjobs = 0;
+	for (i = 0; i < numtextures; i++)
+		if (texturepresent[i] && !texturecache[i])
+		{
+			batch.numjobs++;
+			numpatches += textures[i]->patchcount;
 		}
+
+	if (!batch.numjobs)
+		return 0;
+
+	batch.jobs = malloc(batch.numjobs * sizeof (*batch.jobs));
+	realpatches = malloc((numpatches + 1) * sizeof (*realpatches));
+	if (!batch.jobs || !realpatches)
+		I_Error("%s: Out of memory generating textures", "R_GenerateTextures");
+
+	// Allocate the blocks first, since that caches patches PU_CACHE...
+	batch.numjobs = 0;
+	for (i = 0; i < numtextures; i++)
+	{
+		if (!texturepresent[i] || texturecache[i])
+			continue;
+
+		batch.jobs[batch.numjobs].texnum = i;
+		batch.jobs[batch.numjobs].block = R_AllocateTexture(i);
+		if (batch.jobs[batch.numjobs].block) // holey ones are done already
+			batch.numjobs++;
+	}
+
+	// ...then keep every patch the workers need around until they're done
+	numpatches = 0;
+	for (i = 0; i < batch.numjobs; i++)
+	{
+		texture_t *texture = textures[batch.jobs[i].texnum];
+
+		batch.jobs[i].realpatches = &realpatches[numpatches];
+		for (j = 0; j < texture->patchcount; j++)
+			realpatches[numpatches++] = W_CacheLumpNumPwad(texture->patches[j].wad, texture->patches[j].lump, PU_STATIC);
 	}
 
-done:
-	// Now that the texture has been built in column cache, it is purgable from zone memory.
-	Z_ChangeTag(block, PU_CACHE);
-	return blocktex;
+	batch.numthreads = min(numthreads, batch.numjobs);
+	if (batch.numthreads < 1)
+		batch.numthreads = 1;
+	I_RunParallel(batch.numthreads, R_CompositeTextureJobs, &batch);
+
+	// Now that the textures have been built in column cache, they're purgable from zone memory.
+	for (i = 0; i < batch.numjobs; i++)
+		Z_ChangeTag(batch.jobs[i].block, PU_CACHE);
+	for (i = 0; (size_t)i < numpatches; i++)
+		Z_ChangeTag(realpatches[i], PU_CACHE);
+
+	free(realpatches);
+	free(batch.jobs);
+	return batch.numjobs;
 }
 
 //
@@ -345,6 +476,279 @@ UINT8 *R_GetColumn(fixed_t tex, INT32 col)
 	return data + LONG(texturecolumnofs[tex][col]);
 }
 
+// ==========================================================================
+//                                 MIPMAPS
+// ==========================================================================
+
+// Far away walls and floors skip over most of their texels from one pixel
+// to the next, which sparkles as the view moves and reads memory all over
+// the place. So textures and flats can also have smaller copies of
+// themselves, each half the size of the last, with every texel the nearest
+// palette color to the average of the ones it stands for. The drawers use
+// whichever is closest to a texel per pixel.
+// Wall mips are column-major like the textures, flat mips row-major like
+// the flats, so the drawers don't need to know the difference.
+
+static void R_CheckNearestColorCells(void);
+static UINT8 NearestColor(UINT8 r, UINT8 g, UINT8 b);
+
+#define MIPSUNKNOWN 0xFF // for texturemiplevels
+#define MINMIPSIZE 4 // don't shrink a side smaller than this
+
+static UINT8 **texturemips; // levels 1 and up, one after another
+static UINT8 *texturemiplevels; // how many levels texturemips has
+static RGBA_t mippalette[256]; // the colors the mips were averaged with
+
+typedef struct flatmips_s
+{
+	lumpnum_t lumpnum;
+	UINT8 *mips;
+	INT32 levels;
+	struct flatmips_s *next;
+} flatmips_t;
+
+#define FLATMIPHASH 64
+static flatmips_t *flatmips[FLATMIPHASH];
+
+//
+// R_MipLevels
+//
+// How many times a width by height image can be halved evenly.
+//
+static INT32 R_MipLevels(INT32 width, INT32 height)
+{
+	INT32 levels = 0;
+
+	while (levels < MAXMIPLEVELS && !(width & 1) && !(height & 1)
+		&& (width >> 1) >= MINMIPSIZE && (height >> 1) >= MINMIPSIZE)
+	{
+		width >>= 1;
+		height >>= 1;
+		levels++;
+	}
+
+	return levels;
+}
+
+//
+// R_MipLevel
+//
+// The level to draw with when each pixel steps over step texels.
+//
+INT32 R_MipLevel(fixed_t step, INT32 levels)
+{
+	INT32 level = 0;
+
+	while (level < levels && step >= (FRACUNIT << (level+1)))
+		level++;
+
+	return level;
+}
+
+//
+// R_BuildMips
+//
+// Averages source, width by height texels stored pitch apart along x and
+// one apart along y, into levels smaller copies laid out the same way,
+// one after another in dest.
+//
+static void R_BuildMips(const UINT8 *source, INT32 width, INT32 height, INT32 pitch, INT32 levels, UINT8 *dest)
+{
+	INT32 level, x, y, bx, by, size;
+	INT32 r, g, b;
+	const UINT8 *block;
+
+	R_CheckNearestColorCells();
+
+	for (level = 1; level <= levels; level++)
+	{
+		size = 1 << level;
+		for (x = 0; x < width >> level; x++)
+			for (y = 0; y < height >> level; y++)
+			{
+				r = g = b = 0;
+				for (bx = 0; bx < size; bx++)
+				{
+					block = source + ((x << level) + bx) * pitch + (y << level);
+					for (by = 0; by < size; by++)
+					{
+						r += pLocalPalette[block[by]].s.red;
+						g += pLocalPalette[block[by]].s.green;
+						b += pLocalPalette[block[by]].s.blue;
+					}
+				}
+				// round to nearest
+				r = (r + (size*size >> 1)) >> (2*level);
+				g = (g + (size*size >> 1)) >> (2*level);
+				b = (b + (size*size >> 1)) >> (2*level);
+				*dest++ = NearestColor((UINT8)r, (UINT8)g, (UINT8)b);
+			}
+	}
+}
+
+//
+// R_MipsSize
+//
+// Bytes used by levels mips of a width by height image, after the first.
+//
+static size_t R_MipsSize(INT32 width, INT32 height, INT32 levels)
+{
+	size_t size = 0;
+
+	while (levels--)
+	{
+		width >>= 1;
+		height >>= 1;
+		size += width * height;
+	}
+
+	return size;
+}
+
+//
+// R_GenerateTextureMips
+//
+// Builds the mips of a wall texture that doesn't have holes in it.
+// Only the columns under texturewidthmask are drawn, so only they are kept.
+//
+static void R_GenerateTextureMips(INT32 tex)
+{
+	texture_t *texture = textures[tex];
+	const INT32 width = texturewidthmask[tex] + 1;
+	UINT8 *data;
+
+	R_CheckTextureCache(tex);
+
+	texturemiplevels[tex] = 0;
+	if (texture->holes || width > texture->width)
+		return;
+
+	texturemiplevels[tex] = (UINT8)R_MipLevels(width, texture->height);
+	if (!texturemiplevels[tex])
+		return;
+
+	// Static while it's filled in: R_GetColumn may have to generate the
+	// texture first, which could purge a cache block.
+	data = Z_Malloc(R_MipsSize(width, texture->height, texturemiplevels[tex]), PU_STATIC, &texturemips[tex]);
+	R_BuildMips(R_GetColumn(tex, 0), width, texture->height, texture->height, texturemiplevels[tex], data);
+	Z_ChangeTag(data, PU_CACHE);
+}
+
+//
+// R_GetMipColumn
+//
+// R_GetColumn for mip level *level of a texture, or the closest to it that
+// the texture has, which is put back in *level.
+//
+UINT8 *R_GetMipColumn(fixed_t tex, INT32 col, INT32 *level)
+{
+	UINT8 *data;
+	INT32 width = texturewidthmask[tex] + 1, height = textures[tex]->height, i;
+
+	if (texturemiplevels[tex] == MIPSUNKNOWN)
+		R_GenerateTextureMips(tex);
+
+	if (*level > texturemiplevels[tex])
+		*level = texturemiplevels[tex];
+	if (!*level)
+		return R_GetColumn(tex, col);
+
+	data = texturemips[tex];
+	if (!data)
+	{
+		texturemiplevels[tex] = MIPSUNKNOWN;
+		R_GenerateTextureMips(tex);
+		data = texturemips[tex];
+	}
+
+	for (i = 1; i < *level; i++)
+		data += (width >> i) * (height >> i);
+
+	return data + ((col & texturewidthmask[tex]) >> *level) * (height >> *level);
+}
+
+//
+// R_GetFlatMips
+//
+// Fills in mips[1] and up for a size by size flat lump, mips[0] being the
+// flat itself, and returns how many levels there are.
+//
+INT32 R_GetFlatMips(lumpnum_t lumpnum, INT32 size, UINT8 **mips)
+{
+	flatmips_t *fm;
+	INT32 i;
+
+	for (fm = flatmips[lumpnum % FLATMIPHASH]; fm; fm = fm->next)
+		if (fm->lumpnum == lumpnum)
+			break;
+
+	if (!fm)
+	{
+		fm = Z_Malloc(sizeof (*fm), PU_STATIC, NULL);
+		fm->lumpnum = lumpnum;
+		fm->levels = R_MipLevels(size, size);
+		fm->mips = NULL;
+		if (fm->levels)
+		{
+			fm->mips = Z_Malloc(R_MipsSize(size, size, fm->levels), PU_STATIC, NULL);
+			// flats are row-major, so this averages rows instead of columns
+			R_BuildMips(mips[0], size, size, size, fm->levels, fm->mips);
+		}
+		fm->next = flatmips[lumpnum % FLATMIPHASH];
+		flatmips[lumpnum % FLATMIPHASH] = fm;
+	}
+
+	for (i = 1; i <= fm->levels; i++)
+		mips[i] = fm->mips + R_MipsSize(size, size, i-1);
+
+	return fm->levels;
+}
+
+//
+// R_FlushMips
+//
+// Forgets every mip, to be built again when they're next drawn.
+//
+void R_FlushMips(void)
+{
+	flatmips_t *fm, *next;
+	INT32 i;
+
+	for (i = 0; i < numtextures; i++)
+	{
+		if (texturemips[i])
+			Z_Free(texturemips[i]);
+		texturemiplevels[i] = MIPSUNKNOWN;
+	}
+
+	for (i = 0; i < FLATMIPHASH; i++)
+	{
+		for (fm = flatmips[i]; fm; fm = next)
+		{
+			next = fm->next;
+			if (fm->mips)
+				Z_Free(fm->mips);
+			Z_Free(fm);
+		}
+		flatmips[i] = NULL;
+	}
+}
+
+//
+// R_CheckMipPalette
+//
+// The mips are averaged in the palette's colors, so they have to be built
+// again if it changes.
+//
+void R_CheckMipPalette(void)
+{
+	if (!memcmp(mippalette, pLocalPalette, sizeof (mippalette)))
+		return;
+
+	R_FlushMips();
+	M_Memcpy(mippalette, pLocalPalette, sizeof (mippalette));
+}
+
 // convert flats to hicolor as they are requested
 //
 UINT8 *R_GetFlat(lumpnum_t flatlumpnum)
@@ -359,6 +763,8 @@ void R_FlushTextureCache(void)
 {
 	INT32 i;
 
+	R_FlushMips();
+
 	if (numtextures)
 		for (i = 0; i < numtextures; i++)
 			Z_Free(texturecache[i]);
@@ -386,6 +792,7 @@ void R_LoadTextures(void)
 	// Free previous memory before numtextures change.
 	if (numtextures)
 	{
+		R_FlushMips();
 		for (i = 0; i < numtextures; i++)
 		{
 			Z_Free(textures[i]);
@@ -393,6 +800,8 @@ void R_LoadTextures(void)
 		}
 		Z_Free(texturetranslation);
 		Z_Free(textures);
+		Z_Free(texturemips);
+		Z_Free(texturemiplevels);
 	}
 
 	// Load patches and textures.
@@ -464,6 +873,10 @@ void R_LoadTextures(void)
 	textureheight    = (void *)((UINT8 *)textures + ((numtextures * sizeof(void *)) * 4));
 	// Create translation table for global animation.
 	texturetranslation = Z_Malloc((numtextures + 1) * sizeof(*texturetranslation), PU_STATIC, NULL);
+	// And the smaller copies of them
+	texturemips = Z_Calloc(numtextures * sizeof (*texturemips), PU_STATIC, NULL);
+	texturemiplevels = Z_Malloc(numtextures, PU_STATIC, NULL);
+	memset(texturemiplevels, MIPSUNKNOWN, numtextures);
 
 	for (i = 0; i < numtextures; i++)
 		texturetranslation[i] = i;
@@ -1162,6 +1575,7 @@ INT32 R_ColormapNumForName(char *name)
 //
 static double deltas[256][3], map[256][3];
 
+static void R_CheckNearestColorCells(void);
 static UINT8 NearestColor(UINT8 r, UINT8 g, UINT8 b);
 static int RoundUp(double number);
 
@@ -1304,6 +1718,8 @@ INT32 R_CreateColormap(char *p1, char *p2, char *p3)
 		colormap_p = Z_MallocAlign((256 * 34) + 10, PU_LEVEL, NULL, 8);
 		extra_colormaps[mapnum].colormap = (UINT8 *)colormap_p;
 
+		R_CheckNearestColorCells();
+
 		// Calculate the palette index for each palette index, for each light level
 		// (as well as the two unused colormap lines we inherited from Doom)
 		for (p = 0; p < 34; p++)
@@ -1335,23 +1751,142 @@ INT32 R_CreateColormap(char *p1, char *p2, char *p3)
 #undef ABS2
 			}
 		}
+
+		// Different settings can still come out the same, especially
+		// once NearestColor is done with them; share the table if so.
+		for (i = 0; i < mapnum; i++)
+		{
+			if (foundcolormaps[i] != LUMPERROR || !extra_colormaps[i].colormap)
+				continue;
+			if (!memcmp(extra_colormaps[i].colormap, extra_colormaps[mapnum].colormap, 256 * 34))
+			{
+				Z_Free(extra_colormaps[mapnum].colormap);
+				extra_colormaps[mapnum].colormap = extra_colormaps[i].colormap;
+				break;
+			}
+		}
 	}
 
 	return (INT32)mapnum;
 }
 
+// NearestColor is asked about every entry of every colormap a level
+// makes. Rather than search the whole palette each time, the RGB cube is
+// cut into cells, and each cell remembers which palette entries could
+// possibly be nearest to some color inside it: those no further from the
+// cell than the furthest point of the cell is from the best of them.
+// Only those are searched, so the answer is still exactly the same.
+#define NEARESTCELLBITS 5 // 32x32x32 cells
+#define NEARESTCELLSHIFT (8 - NEARESTCELLBITS)
+#define NEARESTCELLS (1 << (3*NEARESTCELLBITS))
+
+static RGBA_t nearestpalette[256]; // what the cells were worked out for
+static UINT32 *nearestcellstart; // offset into nearestcandidates plus one, 0 if not worked out yet
+static UINT16 *nearestcellcount;
+static UINT8 *nearestcandidates;
+static size_t numnearestcandidates, maxnearestcandidates;
+
+//
+// R_CheckNearestColorCells
+//
+// Forgets the cells if the palette (or gamma) changed since they were
+// worked out.
+//
+static void R_CheckNearestColorCells(void)
+{
+	if (!nearestcellstart)
+	{
+		nearestcellstart = Z_Malloc(NEARESTCELLS * sizeof (*nearestcellstart), PU_STATIC, NULL);
+		nearestcellcount = Z_Malloc(NEARESTCELLS * sizeof (*nearestcellcount), PU_STATIC, NULL);
+	}
+	else if (!memcmp(nearestpalette, pLocalPalette, sizeof (nearestpalette)))
+		return;
+
+	M_Memcpy(nearestpalette, pLocalPalette, sizeof (nearestpalette));
+	memset(nearestcellstart, 0, NEARESTCELLS * sizeof (*nearestcellstart));
+	numnearestcandidates = 0;
+}
+
+//
+// R_FindNearestCandidates
+//
+// Works out which palette entries a cell has to search.
+//
+static void R_FindNearestCandidates(size_t cell)
+{
+	INT32 lo[3], rgb[3], mindist[256];
+	INT32 i, k, d, furthest, best = INT32_MAX;
+	size_t start;
+
+	lo[0] = (INT32)(cell >> (2*NEARESTCELLBITS)) << NEARESTCELLSHIFT;
+	lo[1] = (INT32)((cell >> NEARESTCELLBITS) & ((1 << NEARESTCELLBITS) - 1)) << NEARESTCELLSHIFT;
+	lo[2] = (INT32)(cell & ((1 << NEARESTCELLBITS) - 1)) << NEARESTCELLSHIFT;
+
+	for (i = 0; i < 256; i++)
+	{
+		rgb[0] = nearestpalette[i].s.red;
+		rgb[1] = nearestpalette[i].s.green;
+		rgb[2] = nearestpalette[i].s.blue;
+
+		mindist[i] = furthest = 0;
+		for (k = 0; k < 3; k++)
+		{
+			const INT32 hi = lo[k] + (1 << NEARESTCELLSHIFT) - 1;
+
+			// nearest and furthest points of the cell along this axis
+			if (rgb[k] < lo[k])
+				d = lo[k] - rgb[k];
+			else if (rgb[k] > hi)
+				d = rgb[k] - hi;
+			else
+				d = 0;
+			mindist[i] += d*d;
+
+			d = max(rgb[k] - lo[k], hi - rgb[k]);
+			furthest += d*d;
+		}
+		if (furthest < best)
+			best = furthest;
+	}
+
+	if (numnearestcandidates + 256 > maxnearestcandidates)
+	{
+		maxnearestcandidates = maxnearestcandidates ? maxnearestcandidates * 2 : 16384;
+		nearestcandidates = Z_Realloc(nearestcandidates, maxnearestcandidates, PU_STATIC, NULL);
+	}
+
+	// In palette order, so ties still go to the lowest index
+	start = numnearestcandidates;
+	for (i = 0; i < 256; i++)
+		if (mindist[i] <= best)
+			nearestcandidates[numnearestcandidates++] = (UINT8)i;
+
+	nearestcellstart[cell] = (UINT32)start + 1;
+	nearestcellcount[cell] = (UINT16)(numnearestcandidates - start);
+}
+
 // Thanks to quake2 source!
 // utils3/qdata/images.c
+// Call R_CheckNearestColorCells first.
 static UINT8 NearestColor(UINT8 r, UINT8 g, UINT8 b)
 {
 	int dr, dg, db;
-	int distortion, bestdistortion = 256 * 256 * 4, bestcolor = 0, i;
+	int distortion, bestdistortion = 256 * 256 * 4, bestcolor = 0, i, count;
+	const size_t cell = ((size_t)(r >> NEARESTCELLSHIFT) << (2*NEARESTCELLBITS))
+		| ((size_t)(g >> NEARESTCELLSHIFT) << NEARESTCELLBITS) | (b >> NEARESTCELLSHIFT);
+	const UINT8 *candidate;
 
-	for (i = 0; i < 256; i++)
+	if (!nearestcellstart[cell])
+		R_FindNearestCandidates(cell);
+	candidate = nearestcandidates + nearestcellstart[cell] - 1;
+	count = nearestcellcount[cell];
+
+	for (; count--; candidate++)
 	{
-		dr = r - pLocalPalette[i].s.red;
-		dg = g - pLocalPalette[i].s.green;
-		db = b - pLocalPalette[i].s.blue;
+		i = *candidate;
+		dr = r - nearestpalette[i].s.red;
+		dg = g - nearestpalette[i].s.green;
+		db = b - nearestpalette[i].s.blue;
 		distortion = dr*dr + dg*dg + db*db;
 		if (distortion < bestdistortion)
 		{
@@ -1535,6 +2070,8 @@ void R_PrecacheLevel(void)
 	char *texturepresent, *spritepresent;
 	size_t i, j, k;
 	lumpnum_t lump;
+	precise_t texturetime;
+	INT32 texturesbuilt;
 
 	thinker_t *th;
 	spriteframe_t *sf;
@@ -1573,17 +2110,15 @@ void R_PrecacheLevel(void)
 	// while the sky texture is stored like a wall texture, with a skynum dependent name.
 	texturepresent[skytexture] = 1;
 
-	texturememory = 0;
-	for (j = 0; j < (unsigned)numtextures; j++)
-	{
-		if (!texturepresent[j])
-			continue;
+	// Every frame of an animation will be needed sooner or later.
+	P_MarkAnimatedTextures(texturepresent);
 
-		if (!texturecache[j])
-			R_GenerateTexture(j);
-		// pre-caching individual patches that compose textures became obsolete,
-		// since we cache entire composite textures
-	}
+	texturememory = 0;
+	texturetime = I_GetPreciseTime();
+	texturesbuilt = R_GenerateTextures(texturepresent, cv_renderthreads.value);
+	texturetime = I_GetPreciseTime() - texturetime;
+	// pre-caching individual patches that compose textures became obsolete,
+	// since we cache entire composite textures
 	free(texturepresent);
 
 	//
@@ -1622,4 +2157,6 @@ void R_PrecacheLevel(void)
 			"flatmemory:    %s k\n"
 			"texturememory: %s k\n"
 			"spritememory:  %s k\n", sizeu1(flatmemory>>10), sizeu2(texturememory>>10), sizeu3(spritememory>>10));
+	CONS_Debug(DBG_SETUP, "composited %d textures on %d threads in %d ms\n",
+			texturesbuilt, cv_renderthreads.value, I_PreciseToMicros(texturetime)/1000);
 }
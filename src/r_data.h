@@ -73,6 +73,14 @@ UINT8 *R_GetColumn(fixed_t tex, INT32 col);
 
 UINT8 *R_GetFlat(lumpnum_t flatnum);
 
+// Smaller copies of textures and flats, for far away surfaces
+#define MAXMIPLEVELS 4
+INT32 R_MipLevel(fixed_t step, INT32 levels);
+UINT8 *R_GetMipColumn(fixed_t tex, INT32 col, INT32 *level);
+INT32 R_GetFlatMips(lumpnum_t lumpnum, INT32 size, UINT8 **mips);
+void R_FlushMips(void);
+void R_CheckMipPalette(void);
+
 // I/O, setting up the stuff.
 void R_InitData(void);
 void R_PrecacheLevel(void);
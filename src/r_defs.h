@@ -179,6 +179,17 @@ typedef struct ffloor_s
 	INT32 spawnalpha; // alpha the 3D floor spawned with
 } ffloor_t;
 
+// One entry of a sector's 3D floor height index, see P_FirstFFloorInRange.
+// Entries are sorted by bottomheight.
+typedef struct ffloorspan_s
+{
+	ffloor_t *rover;
+	fixed_t bottomheight; // INT32_MIN if the bottom is sloped
+	fixed_t topheight; // INT32_MAX if the top is sloped
+	fixed_t maxtop; // highest topheight of this and all previous entries
+	size_t order; // position in the sector's ffloors list
+} ffloorspan_t;
+
 
 // This struct holds information for shadows casted by 3D floors.
 // This information is contained inside the sector_t and is used as the base
@@ -263,6 +274,7 @@ typedef struct pslope_s
 	struct line_s *sourceline; // The line that generated the slope
 	fixed_t extent; // Distance value used for recalculating zdelta
 	UINT8 refpos; // 1=front floor 2=front ceiling 3=back floor 4=back ceiling (used for dynamic sloping)
+	fixed_t sourceheights[3]; // Heights the slope was last calculated from; dynamic slopes are only recalculated when these change
 
 	UINT8 flags; // Slope options
 	mapthing_t **vertices; // List should be three long for slopes made by vertex things, or one long for slopes using one vertex thing to anchor
@@ -344,8 +356,13 @@ typedef struct sector_s
 	size_t numattached;
 	size_t maxattached;
 	lightlist_t *lightlist;
-	INT32 numlights;
-	boolean moved;
+	INT32 numlights, maxlights;
+	boolean moved; // lightlist needs rebuilding
+
+	// ffloors sorted by height, rebuilt when ffloorsmoved is set
+	ffloorspan_t *ffloorspans;
+	size_t numffloorspans, maxffloorspans;
+	boolean ffloorsmoved;
 
 	// per-sector colormaps!
 	extracolormap_t *extra_colormap;
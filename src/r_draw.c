@@ -25,6 +25,7 @@
 #include "w_wad.h"
 #include "z_zone.h"
 #include "console.h" // Until buffering gets finished
+#include "i_system.h" // I_RunParallel
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -107,6 +108,7 @@ UINT8 *ds_transmap; // one of the translucency tables
 pslope_t *ds_slope; // Current slope being used
 floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
 float focallengthf, zeroheight;
+INT32 ds_tiltspansize = 16; // pixels between perspective divides
 #endif
 
 /**	\brief Variable flat sizes
@@ -122,15 +124,27 @@ UINT32 nflatxshift, nflatyshift, nflatshiftup, nflatmask;
 //                   TRANSLATION COLORMAP CODE
 // =========================================================================
 
-#define DEFAULT_TT_CACHE_INDEX MAXSKINS
-#define BOSS_TT_CACHE_INDEX (MAXSKINS + 1)
-#define METALSONIC_TT_CACHE_INDEX (MAXSKINS + 2)
-#define ALLWHITE_TT_CACHE_INDEX (MAXSKINS + 3)
 #define SKIN_RAMP_LENGTH 16
 #define DEFAULT_STARTTRANSCOLOR 160
 #define NUM_PALETTE_ENTRIES 256
 
-static UINT8** translationtablecache[MAXSKINS + 4] = {NULL};
+// Translation colormaps are cached by what they contain rather than by skin,
+// so skins sharing a ramp share their maps. There can only be one ramp per
+// skin plus the default, so the cache can never hold more than
+// (MAXSKINS + 1) * MAXTRANSLATIONS maps plus the few that ignore the color;
+// it is sized so that it never fills up, and nothing is ever evicted.
+// The maps stay put for the whole session, so their addresses can be kept,
+// as the OpenGL renderer does for its mipmaps of translated patches.
+#define TRANSLATIONCACHESIZE 2048
+
+typedef struct
+{
+	UINT32 key;
+	UINT8 *colormap; // NULL if the slot is free
+} translationcache_t;
+
+static translationcache_t translationcache[TRANSLATIONCACHESIZE];
+static UINT32 numtranslations, translationhits, translationmisses, translationuncached;
 
 
 // See also the enum skincolors_t
@@ -498,6 +512,25 @@ static void R_GenerateTranslationColormap(UINT8 *dest_colormap, INT32 skinnum, U
 }
 
 
+//
+// R_TranslationKey
+// What the colormap for this skin and color will hold, packed into a number.
+//
+static UINT32 R_TranslationKey(INT32 skinnum, skincolors_t color)
+{
+	// These ignore the color altogether; see R_GenerateTranslationColormap
+	if (skinnum == TC_BOSS)
+		return 0x10000;
+	if (skinnum == TC_METALSONIC)
+		return 0x10100;
+	if (skinnum == TC_ALLWHITE)
+		return 0x10200;
+	if (color == SKINCOLOR_NONE)
+		return 0; // the identity map
+
+	return ((skinnum == TC_DEFAULT ? DEFAULT_STARTTRANSCOLOR : skins[skinnum].starttranscolor) << 8) | color;
+}
+
 /**	\brief	Retrieves a translation colormap from the cache.
 
 	\param	skinnum	number of skin, TC_DEFAULT or TC_BOSS
@@ -509,56 +542,70 @@ static void R_GenerateTranslationColormap(UINT8 *dest_colormap, INT32 skinnum, U
 UINT8* R_GetTranslationColormap(INT32 skinnum, skincolors_t color, UINT8 flags)
 {
 	UINT8* ret;
-	INT32 skintableindex;
-
-	// Adjust if we want the default colormap
-	if (skinnum == TC_DEFAULT) skintableindex = DEFAULT_TT_CACHE_INDEX;
-	else if (skinnum == TC_BOSS) skintableindex = BOSS_TT_CACHE_INDEX;
-	else if (skinnum == TC_METALSONIC) skintableindex = METALSONIC_TT_CACHE_INDEX;
-	else if (skinnum == TC_ALLWHITE) skintableindex = ALLWHITE_TT_CACHE_INDEX;
-	else skintableindex = skinnum;
+	UINT32 key, slot;
 
-	if (flags & GTC_CACHE)
+	if (!(flags & GTC_CACHE))
 	{
-
-		// Allocate table for skin if necessary
-		if (!translationtablecache[skintableindex])
-			translationtablecache[skintableindex] = Z_Calloc(MAXTRANSLATIONS * sizeof(UINT8**), PU_STATIC, NULL);
-
-		// Get colormap
-		ret = translationtablecache[skintableindex][color];
+		translationuncached++;
+		ret = Z_MallocAlign(NUM_PALETTE_ENTRIES, PU_STATIC, NULL, 8);
+		R_GenerateTranslationColormap(ret, skinnum, color);
+		return ret;
 	}
-	else ret = NULL;
 
-	// Generate the colormap if necessary
-	if (!ret)
+	key = R_TranslationKey(skinnum, color);
+	slot = (key * 2654435761u) >> 21; // Fibonacci hash down to 11 bits
+	while (translationcache[slot].colormap)
 	{
-		ret = Z_MallocAlign(NUM_PALETTE_ENTRIES, (flags & GTC_CACHE) ? PU_LEVEL : PU_STATIC, NULL, 8);
-		R_GenerateTranslationColormap(ret, skinnum, color);
-
-		// Cache the colormap if desired
-		if (flags & GTC_CACHE)
-			translationtablecache[skintableindex][color] = ret;
+		if (translationcache[slot].key == key)
+		{
+			translationhits++;
+			return translationcache[slot].colormap;
+		}
+		slot = (slot + 1) & (TRANSLATIONCACHESIZE - 1);
 	}
 
+	// Generate the colormap, and keep it for good
+	I_Assert(numtranslations < TRANSLATIONCACHESIZE - 1);
+	translationmisses++;
+	numtranslations++;
+	ret = Z_MallocAlign(NUM_PALETTE_ENTRIES, PU_STATIC, NULL, 8);
+	R_GenerateTranslationColormap(ret, skinnum, color);
+	translationcache[slot].key = key;
+	translationcache[slot].colormap = ret;
+
 	return ret;
 }
 
-/**	\brief	Flushes cache of translation colormaps.
+/**	\brief	Makes sure every translation colormap a level could ask for
+	is in the cache, so none are made halfway through a frame.
 
-	Flushes cache of translation colormaps, but doesn't actually free the
-	colormaps themselves. These are freed when PU_LEVEL blocks are purged,
-	at or before which point, this function should be called.
+	Only the skins added since the last call cost anything.
 
 	\return	void
 */
-void R_FlushTranslationColormapCache(void)
+void R_PrecacheTranslationColormaps(void)
 {
-	INT32 i;
+	INT32 skinnum, color;
+
+	R_GetTranslationColormap(TC_BOSS, SKINCOLOR_NONE, GTC_CACHE);
+	R_GetTranslationColormap(TC_METALSONIC, SKINCOLOR_NONE, GTC_CACHE);
+	R_GetTranslationColormap(TC_ALLWHITE, SKINCOLOR_NONE, GTC_CACHE);
 
-	for (i = 0; i < (INT32)(sizeof(translationtablecache) / sizeof(translationtablecache[0])); i++)
-		if (translationtablecache[i])
-			memset(translationtablecache[i], 0, MAXTRANSLATIONS * sizeof(UINT8**));
+	for (skinnum = TC_DEFAULT; skinnum < numskins; skinnum++)
+		for (color = SKINCOLOR_NONE; color < MAXTRANSLATIONS; color++)
+			R_GetTranslationColormap(skinnum, color, GTC_CACHE);
+}
+
+//
+// Command_TranslationStats_f
+// Prints how well the translation colormap cache is doing.
+//
+void Command_TranslationStats_f(void)
+{
+	CONS_Printf(M_GetText("Translation colormaps: %u cached (%u KB) in %d slots\n"),
+		numtranslations, numtranslations * NUM_PALETTE_ENTRIES / 1024, TRANSLATIONCACHESIZE);
+	CONS_Printf(M_GetText("Hits: %u, misses: %u, uncached: %u\n"),
+		translationhits, translationmisses, translationuncached);
 }
 
 UINT8 R_GetColorByName(const char *name)
@@ -625,6 +672,11 @@ void R_InitViewBuffer(INT32 width, INT32 height)
 		ylookup[i] = ylookup1[i] = screens[0] + (i+viewwindowy)*vid.width*bytesperpixel;
 		ylookup2[i] = screens[0] + (i+(vid.height>>1))*vid.width*bytesperpixel; // for splitscreen
 	}
+
+	viewcontexts[0].windowy = viewwindowy;
+	viewcontexts[0].ylookup = ylookup1;
+	viewcontexts[1].windowy = vid.height>>1;
+	viewcontexts[1].ylookup = ylookup2;
 }
 
 /**	\brief viewborder patches lump numbers
@@ -791,12 +843,121 @@ void R_DrawViewBorder(void)
 }
 #endif
 
+// ==========================================================================
+//                      THREADED WALL COLUMN DRAWING
+// ==========================================================================
+
+// Solid wall columns never overlap each other while the BSP is walked, so
+// instead of drawing them as they are found, they can be saved up and drawn
+// afterwards. Each vertical slice of the view gets its own list, and the
+// slices are drawn by separate threads. Every screen column belongs to
+// exactly one slice, so the result is the same as drawing them in place.
+
+typedef struct
+{
+	wallcolumn_t *columns;
+	size_t numcolumns, maxcolumns;
+} wallslice_t;
+
+static wallslice_t wallslices[MAXRENDERTHREADS];
+static INT32 numwallslices = 0;
+
+static void R_QueueWallColumn(void)
+{
+	wallslice_t *slice;
+	wallcolumn_t *wc;
+	INT32 i = dc_x * numwallslices / viewwidth;
+
+	if (dc_yh < dc_yl)
+		return;
+
+	if (i < 0)
+		i = 0;
+	else if (i >= numwallslices)
+		i = numwallslices - 1;
+	slice = &wallslices[i];
+
+	if (slice->numcolumns == slice->maxcolumns)
+	{
+		slice->maxcolumns = slice->maxcolumns ? slice->maxcolumns*2 : 256;
+		slice->columns = Z_Realloc(slice->columns, slice->maxcolumns * sizeof (*slice->columns), PU_STATIC, NULL);
+	}
+
+	wc = &slice->columns[slice->numcolumns++];
+	wc->source = dc_source;
+	wc->colormap = dc_colormap;
+	wc->fracstep = dc_iscale;
+	wc->frac = (dc_texturemid + FixedMul((dc_yl << FRACBITS) - centeryfrac, dc_iscale))*(!dc_hires);
+	wc->x = dc_x;
+	wc->yl = dc_yl;
+	wc->yh = dc_yh;
+	wc->texheight = dc_texheight;
+}
+
+static void R_DrawWallSlice(INT32 index, void *userdata)
+{
+	const wallslice_t *slice = &wallslices[index];
+	size_t i;
+
+	(void)userdata;
+	for (i = 0; i < slice->numcolumns; i++)
+		R_DrawQueuedColumn_8(&slice->columns[i]);
+}
+
+/**	\brief	Starts queueing solid wall columns instead of drawing them
+
+	\param	threads	number of threads to draw them with; 1 draws them in place as usual
+
+	\return	void
+*/
+void R_StartWallColumns(INT32 threads)
+{
+	// The assembly drawers work off the dc_ globals
+	if (threads <= 1 || walldrawerfunc != R_DrawWallColumn_8)
+		return;
+
+	numwallslices = min(threads, MAXRENDERTHREADS);
+	wallcolfunc = colfunc = R_QueueWallColumn;
+}
+
+/**	\brief	Draws every queued wall column, and keeps queueing
+*/
+void R_FlushWallColumns(void)
+{
+	INT32 i;
+
+	if (!numwallslices)
+		return;
+
+	I_RunParallel(numwallslices, R_DrawWallSlice, NULL);
+
+	for (i = 0; i < numwallslices; i++)
+		wallslices[i].numcolumns = 0;
+}
+
+/**	\brief	Draws every queued wall column, and goes back to drawing them in place
+*/
+void R_FinishWallColumns(void)
+{
+	if (!numwallslices)
+		return;
+
+	R_FlushWallColumns();
+	numwallslices = 0;
+	wallcolfunc = colfunc = walldrawerfunc;
+}
+
 // ==========================================================================
 //                   INCLUDE 8bpp DRAWING CODE HERE
 // ==========================================================================
 
 #include "r_draw8.c"
 
+#ifdef HAVE_SSE2DRAWERS
+#include <emmintrin.h>
+#include "r_draw8_sse2.c"
+#endif
+
 // ==========================================================================
 //                   INCLUDE 16bpp DRAWING CODE HERE
 // ==========================================================================
@@ -804,3 +965,194 @@ void R_DrawViewBorder(void)
 #ifdef HIGHCOLOR
 #include "r_draw16.c"
 #endif
+
+// ==========================================================================
+//                   DRAWER BENCHMARK
+// ==========================================================================
+
+typedef struct
+{
+	const char *name;
+	void (*func)(void);
+	boolean span;
+} drawerbench_t;
+
+static drawerbench_t drawerbenches[] =
+{
+	{"R_DrawSpan_8", R_DrawSpan_8, true},
+	{"R_DrawTranslucentSpan_8", R_DrawTranslucentSpan_8, true},
+	{"R_DrawFogSpan_8", R_DrawFogSpan_8, true},
+#ifdef HAVE_SSE2DRAWERS
+	{"R_DrawSpan_8_SSE2", R_DrawSpan_8_SSE2, true},
+	{"R_DrawTranslucentSpan_8_SSE2", R_DrawTranslucentSpan_8_SSE2, true},
+	{"R_DrawFogSpan_8_SSE2", R_DrawFogSpan_8_SSE2, true},
+#endif
+	{"R_DrawColumn_8", R_DrawColumn_8, false},
+	{"R_DrawTranslucentColumn_8", R_DrawTranslucentColumn_8, false},
+	{NULL, NULL, false}
+};
+
+#ifdef ESLOPE
+//
+// R_BenchTiltedSpan
+// Draws the sloped test plane over the lower half of the view, dividing
+// every spansize pixels, and returns how long it took in microseconds.
+//
+static INT32 R_BenchTiltedSpan(INT32 spansize, INT32 frames)
+{
+	precise_t start = I_GetPreciseTime();
+	INT32 frame;
+
+	ds_tiltspansize = spansize;
+	for (frame = 0; frame < frames; frame++)
+	{
+		for (ds_y = centery + 1; ds_y < viewheight; ds_y++)
+		{
+			ds_x1 = 0;
+			ds_x2 = viewwidth - 1;
+			R_DrawTiltedSpan_8();
+		}
+	}
+
+	return max(1, I_PreciseToMicros(I_GetPreciseTime() - start));
+}
+
+//
+// R_BenchTiltedSpans
+// Compares R_DrawTiltedSpan_8 at several subdivision sizes against the
+// exact per-pixel divide, in speed and in pixels that come out different.
+//
+static void R_BenchTiltedSpans(INT32 frames)
+{
+	static const INT32 sizes[] = {1, 4, 8, 16, 32, 0};
+	const float sfmult = 65536.f*(1<<nflatshiftup);
+	INT32 rows = viewheight - centery - 1;
+	INT32 i, y, x, us;
+	UINT8 *exact, *dest;
+	UINT32 diff;
+
+	if (rows <= 0)
+		return;
+
+	// A floor 64 units below the view, rising a quarter unit per unit forward,
+	// set up the same way R_DrawSinglePlane does
+	ds_su.x = -64.f*sfmult;
+	ds_su.y = ds_su.z = 0.f;
+	ds_sv.x = ds_sv.y = 0.f;
+	ds_sv.z = 64.f*focallengthf*sfmult;
+	ds_sz.x = 0.f;
+	ds_sz.y = 1.f;
+	ds_sz.z = -0.25f*focallengthf;
+	zeroheight = FIXED_TO_FLOAT(viewz) - 64.f;
+	planezlight = scalelight[LIGHTLEVELS-1];
+	ds_colormap = colormaps;
+
+	exact = Z_Malloc(rows*viewwidth, PU_STATIC, NULL);
+
+	for (i = 0; sizes[i]; i++)
+	{
+		us = R_BenchTiltedSpan(sizes[i], frames);
+
+		diff = 0;
+		for (y = 0; y < rows; y++)
+		{
+			dest = ylookup[centery + 1 + y] + columnofs[0];
+			if (i == 0)
+				M_Memcpy(exact + y*viewwidth, dest, viewwidth);
+			else for (x = 0; x < viewwidth; x++)
+				diff += (dest[x] != exact[y*viewwidth + x]);
+		}
+
+		CONS_Printf("R_DrawTiltedSpan_8 %2d px       %6d us %5u Mpix/s, %u.%02u%% off exact\n",
+			sizes[i], us, (UINT32)((UINT64)rows * viewwidth * frames / (UINT32)us),
+			diff*100 / (rows*viewwidth), (UINT32)((UINT64)diff*10000 / (rows*viewwidth)) % 100);
+	}
+
+	Z_Free(exact);
+}
+#endif
+
+//
+// Command_DrawerBench_f
+// Times each 8bpp drawer filling the view window with a 64x64 pattern,
+// and prints its throughput. Scribbles over the screen until the next frame.
+//
+void Command_DrawerBench_f(void)
+{
+	static UINT8 benchflat[64*64];
+	drawerbench_t *bench;
+	INT32 frames = 20, frame, i;
+
+	if (rendermode != render_soft)
+	{
+		CONS_Printf(M_GetText("drawerbench only works in software mode.\n"));
+		return;
+	}
+
+	if (COM_Argc() > 1)
+		frames = max(1, atoi(COM_Argv(1)));
+
+	for (i = 0; i < 64*64; i++)
+		benchflat[i] = (UINT8)(i ^ (i >> 6));
+
+	// 64x64 flat, as set up by R_DrawSinglePlane
+	nflatmask = 0xFC0;
+	nflatxshift = 26;
+	nflatyshift = 20;
+	nflatshiftup = 10;
+	ds_source = dc_source = benchflat;
+	ds_colormap = dc_colormap = colormaps;
+	ds_transmap = dc_transmap = transtables + ((tr_trans50-1)<<FF_TRANSSHIFT);
+	dc_texheight = 64;
+	dc_hires = 0;
+
+	CONS_Printf(M_GetText("%dx%d, %d frames:\n"), viewwidth, viewheight, frames);
+
+	for (bench = drawerbenches; bench->name; bench++)
+	{
+		precise_t start;
+		INT32 us;
+		UINT64 pixels = (UINT64)viewwidth * viewheight * frames;
+
+#ifdef HAVE_SSE2DRAWERS
+		if (!R_SSE2 && strstr(bench->name, "_SSE2"))
+			continue;
+#endif
+
+		start = I_GetPreciseTime();
+		for (frame = 0; frame < frames; frame++)
+		{
+			if (bench->span)
+			{
+				ds_xstep = FRACUNIT/3 + frame;
+				ds_ystep = FRACUNIT/7;
+				ds_x1 = 0;
+				ds_x2 = viewwidth - 1;
+				for (ds_y = 0; ds_y < viewheight; ds_y++)
+				{
+					ds_xfrac = ds_y * FRACUNIT/5;
+					ds_yfrac = ds_y * FRACUNIT/2;
+					bench->func();
+				}
+			}
+			else
+			{
+				dc_iscale = FRACUNIT/3 + frame;
+				dc_texturemid = 0;
+				dc_yl = 0;
+				dc_yh = viewheight - 1;
+				for (dc_x = 0; dc_x < viewwidth; dc_x++)
+					bench->func();
+			}
+		}
+		us = I_PreciseToMicros(I_GetPreciseTime() - start);
+		if (us <= 0)
+			us = 1;
+
+		CONS_Printf("%-30s %6d us %5u Mpix/s\n", bench->name, us, (UINT32)(pixels / (UINT32)us));
+	}
+
+#ifdef ESLOPE
+	R_BenchTiltedSpans(frames);
+#endif
+}
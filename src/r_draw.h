@@ -68,6 +68,7 @@ typedef struct {
 extern pslope_t *ds_slope; // Current slope being used
 extern floatv3_t ds_su, ds_sv, ds_sz; // Vectors for... stuff?
 extern float focallengthf, zeroheight;
+extern INT32 ds_tiltspansize;
 #endif
 
 // Variable flat sizes
@@ -109,9 +110,26 @@ extern lumpnum_t viewborderlump[8];
 // Initialize color translation tables, for player rendering etc.
 void R_InitTranslationTables(void);
 UINT8* R_GetTranslationColormap(INT32 skinnum, skincolors_t color, UINT8 flags);
-void R_FlushTranslationColormapCache(void);
+void R_PrecacheTranslationColormaps(void);
+void Command_TranslationStats_f(void);
 UINT8 R_GetColorByName(const char *name);
 
+// Drawing solid wall columns on several threads
+#define MAXRENDERTHREADS 16
+
+// A wall column queued by R_StartWallColumns, drawn by R_DrawQueuedColumn_8
+typedef struct
+{
+	UINT8 *source;
+	lighttable_t *colormap;
+	fixed_t frac, fracstep;
+	INT32 x, yl, yh, texheight;
+} wallcolumn_t;
+
+void R_StartWallColumns(INT32 threads);
+void R_FlushWallColumns(void);
+void R_FinishWallColumns(void);
+
 // Custom player skin translation
 void R_InitViewBuffer(INT32 width, INT32 height);
 void R_InitViewBorder(void);
@@ -125,6 +143,9 @@ void R_FillBackScreen(void);
 void R_DrawViewBorder(void);
 #endif
 
+// Times the 8bpp drawers.
+void Command_DrawerBench_f(void);
+
 // -----------------
 // 8bpp DRAWING CODE
 // -----------------
@@ -165,6 +186,16 @@ void R_Draw2sMultiPatchTranslucentColumn_8(void);
 void R_DrawFogSpan_8(void);
 void R_DrawFogColumn_8(void);
 void R_DrawColumnShadowed_8(void);
+void R_DrawQueuedColumn_8(const wallcolumn_t *wc);
+
+// Span drawers that need SSE2; only built when the compiler can emit it,
+// and only used when I_CPUInfo reports it.
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SSE2DRAWERS
+void R_DrawSpan_8_SSE2(void);
+void R_DrawTranslucentSpan_8_SSE2(void);
+void R_DrawFogSpan_8_SSE2(void);
+#endif
 
 // ------------------
 // 16bpp DRAWING CODE
@@ -19,6 +19,59 @@
 // a has a constant z depth from top to bottom.
 //
 
+/**	\brief The R_DrawColumnLoop_8 function
+	The inner loop of R_DrawColumn_8 and R_DrawQueuedColumn_8: draws count
+	pixels down from dest, stepping through the texture column by fracstep.
+*/
+static inline void R_DrawColumnLoop_8(register UINT8 *dest, INT32 count, register fixed_t frac, fixed_t fracstep,
+	register const UINT8 *source, register const lighttable_t *colormap, INT32 texheight)
+{
+	register INT32 heightmask = texheight-1;
+	if (texheight & heightmask)   // not a power of 2 -- killough
+	{
+		heightmask++;
+		heightmask <<= FRACBITS;
+
+		if (frac < 0)
+			while ((frac += heightmask) <  0);
+		else
+			while (frac >= heightmask)
+				frac -= heightmask;
+
+		do
+		{
+			// Re-map color indices from wall texture column
+			//  using a lighting/special effects LUT.
+			// heightmask is the Tutti-Frutti fix
+			*dest = colormap[source[frac>>FRACBITS]];
+			dest += vid.width;
+
+			// Avoid overflow.
+			if (fracstep > 0x7FFFFFFF - frac)
+				frac += fracstep - heightmask;
+			else
+				frac += fracstep;
+
+			while (frac >= heightmask)
+				frac -= heightmask;
+		} while (--count);
+	}
+	else
+	{
+		while ((count -= 2) >= 0) // texture height is a power of 2
+		{
+			*dest = colormap[source[(frac>>FRACBITS) & heightmask]];
+			dest += vid.width;
+			frac += fracstep;
+			*dest = colormap[source[(frac>>FRACBITS) & heightmask]];
+			dest += vid.width;
+			frac += fracstep;
+		}
+		if (count & 1)
+			*dest = colormap[source[(frac>>FRACBITS) & heightmask]];
+	}
+}
+
 /**	\brief The R_DrawColumn_8 function
 	Experiment to make software go faster. Taken from the Boom source
 */
@@ -55,54 +108,29 @@ void R_DrawColumn_8(void)
 
 	// Inner loop that does the actual texture mapping, e.g. a DDA-like scaling.
 	// This is as fast as it gets.
-	{
-		register const UINT8 *source = dc_source;
-		register const lighttable_t *colormap = dc_colormap;
-		register INT32 heightmask = dc_texheight-1;
-		if (dc_texheight & heightmask)   // not a power of 2 -- killough
-		{
-			heightmask++;
-			heightmask <<= FRACBITS;
+	R_DrawColumnLoop_8(dest, count, frac, fracstep, dc_source, dc_colormap, dc_texheight);
+}
 
-			if (frac < 0)
-				while ((frac += heightmask) <  0);
-			else
-				while (frac >= heightmask)
-					frac -= heightmask;
+/**	\brief The R_DrawQueuedColumn_8 function
+	Same as R_DrawColumn_8, but takes everything from a queued wall column
+	instead of the dc_ globals, so several can run at once.
+*/
+void R_DrawQueuedColumn_8(const wallcolumn_t *wc)
+{
+	INT32 count;
 
-			do
-			{
-				// Re-map color indices from wall texture column
-				//  using a lighting/special effects LUT.
-				// heightmask is the Tutti-Frutti fix
-				*dest = colormap[source[frac>>FRACBITS]];
-				dest += vid.width;
+	count = wc->yh - wc->yl;
 
-				// Avoid overflow.
-				if (fracstep > 0x7FFFFFFF - frac)
-					frac += fracstep - heightmask;
-				else
-					frac += fracstep;
+	if (count < 0) // Zero length, column does not exceed a pixel.
+		return;
 
-				while (frac >= heightmask)
-					frac -= heightmask;
-			} while (--count);
-		}
-		else
-		{
-			while ((count -= 2) >= 0) // texture height is a power of 2
-			{
-				*dest = colormap[source[(frac>>FRACBITS) & heightmask]];
-				dest += vid.width;
-				frac += fracstep;
-				*dest = colormap[source[(frac>>FRACBITS) & heightmask]];
-				dest += vid.width;
-				frac += fracstep;
-			}
-			if (count & 1)
-				*dest = colormap[source[(frac>>FRACBITS) & heightmask]];
-		}
-	}
+#ifdef RANGECHECK
+	if ((unsigned)wc->x >= (unsigned)vid.width || wc->yl < 0 || wc->yh >= vid.height)
+		return;
+#endif
+
+	R_DrawColumnLoop_8(&topleft[wc->yl*vid.width + wc->x], count + 1, wc->frac, wc->fracstep,
+		wc->source, wc->colormap, wc->texheight);
 }
 
 #define TRANSPARENTPIXEL 247
@@ -630,10 +658,19 @@ void R_CalcTiltedLighting(fixed_t start, fixed_t end)
 	// of this function. Here's my own.
 	INT32 left = ds_x1, right = ds_x2;
 	fixed_t step = (end-start)/(ds_x2-ds_x1+1);
+	INT64 first, last;
 	INT32 i;
 
-	// I wanna do some optimizing by checking for out-of-range segments on either side to fill in all at once,
-	// but I'm too bad at coding to not crash the game trying to do that. I guess this is fast enough for now...
+	// The light is linear across the span, so if both ends are in range
+	// everything between is too, and the clamping can be skipped.
+	first = (INT64)start + step;
+	last = (INT64)start + (INT64)step*(right-left+1);
+	if (first >= 0 && (first >> FRACBITS) < MAXLIGHTSCALE && last >= 0 && (last >> FRACBITS) < MAXLIGHTSCALE)
+	{
+		for (i = left; i <= right; i++)
+			tiltlighting[i] = (start += step) >> FRACBITS;
+		return;
+	}
 
 	for (i = left; i <= right; i++) {
 		tiltlighting[i] = (start += step) >> FRACBITS;
@@ -664,6 +701,8 @@ void R_DrawTiltedSpan_8(void)
 	double izstep, uzstep, vzstep;
 	double endz, endu, endv;
 	UINT32 stepu, stepv;
+	INT32 spansize;
+	double invspan;
 
 	iz = ds_sz.z + ds_sz.y*(centery-ds_y) + ds_sz.x*(ds_x1-centerx);
 
@@ -704,20 +743,20 @@ void R_DrawTiltedSpan_8(void)
 		vz += ds_sv.x;
 	} while (--width >= 0);
 #else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
+	spansize = ds_tiltspansize;
+	invspan = 1.0/spansize;
 
 	startz = 1.f/iz;
 	startu = uz*startz;
 	startv = vz*startz;
 
-	izstep = ds_sz.x * SPANSIZE;
-	uzstep = ds_su.x * SPANSIZE;
-	vzstep = ds_sv.x * SPANSIZE;
+	izstep = ds_sz.x * spansize;
+	uzstep = ds_su.x * spansize;
+	vzstep = ds_sv.x * spansize;
 	//x1 = 0;
 	width++;
 
-	while (width >= SPANSIZE)
+	while (width >= spansize)
 	{
 		iz += izstep;
 		uz += uzstep;
@@ -726,12 +765,12 @@ void R_DrawTiltedSpan_8(void)
 		endz = 1.f/iz;
 		endu = uz*endz;
 		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
+		stepu = (INT64)((endu - startu) * invspan);
+		stepv = (INT64)((endv - startv) * invspan);
 		u = (INT64)(startu) + viewx;
 		v = (INT64)(startv) + viewy;
 
-		for (i = SPANSIZE-1; i >= 0; i--)
+		for (i = spansize-1; i >= 0; i--)
 		{
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
@@ -741,14 +780,14 @@ void R_DrawTiltedSpan_8(void)
 		}
 		startu = endu;
 		startv = endv;
-		width -= SPANSIZE;
+		width -= spansize;
 	}
 	if (width > 0)
 	{
 		if (width == 1)
 		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
+			u = (INT64)(startu) + viewx;
+			v = (INT64)(startv) + viewy;
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 			*dest = colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]];
 		}
@@ -800,6 +839,8 @@ void R_DrawTiltedTranslucentSpan_8(void)
 	double izstep, uzstep, vzstep;
 	double endz, endu, endv;
 	UINT32 stepu, stepv;
+	INT32 spansize;
+	double invspan;
 
 	iz = ds_sz.z + ds_sz.y*(centery-ds_y) + ds_sz.x*(ds_x1-centerx);
 
@@ -839,20 +880,20 @@ void R_DrawTiltedTranslucentSpan_8(void)
 		vz += ds_sv.x;
 	} while (--width >= 0);
 #else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
+	spansize = ds_tiltspansize;
+	invspan = 1.0/spansize;
 
 	startz = 1.f/iz;
 	startu = uz*startz;
 	startv = vz*startz;
 
-	izstep = ds_sz.x * SPANSIZE;
-	uzstep = ds_su.x * SPANSIZE;
-	vzstep = ds_sv.x * SPANSIZE;
+	izstep = ds_sz.x * spansize;
+	uzstep = ds_su.x * spansize;
+	vzstep = ds_sv.x * spansize;
 	//x1 = 0;
 	width++;
 
-	while (width >= SPANSIZE)
+	while (width >= spansize)
 	{
 		iz += izstep;
 		uz += uzstep;
@@ -861,12 +902,12 @@ void R_DrawTiltedTranslucentSpan_8(void)
 		endz = 1.f/iz;
 		endu = uz*endz;
 		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
+		stepu = (INT64)((endu - startu) * invspan);
+		stepv = (INT64)((endv - startv) * invspan);
 		u = (INT64)(startu) + viewx;
 		v = (INT64)(startv) + viewy;
 
-		for (i = SPANSIZE-1; i >= 0; i--)
+		for (i = spansize-1; i >= 0; i--)
 		{
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
@@ -876,14 +917,14 @@ void R_DrawTiltedTranslucentSpan_8(void)
 		}
 		startu = endu;
 		startv = endv;
-		width -= SPANSIZE;
+		width -= spansize;
 	}
 	if (width > 0)
 	{
 		if (width == 1)
 		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
+			u = (INT64)(startu) + viewx;
+			v = (INT64)(startv) + viewy;
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 			*dest = *(ds_transmap + (colormap[source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)]] << 8) + *dest);
 		}
@@ -934,6 +975,8 @@ void R_DrawTiltedSplat_8(void)
 	double izstep, uzstep, vzstep;
 	double endz, endu, endv;
 	UINT32 stepu, stepv;
+	INT32 spansize;
+	double invspan;
 
 	iz = ds_sz.z + ds_sz.y*(centery-ds_y) + ds_sz.x*(ds_x1-centerx);
 
@@ -976,20 +1019,20 @@ void R_DrawTiltedSplat_8(void)
 		vz += ds_sv.x;
 	} while (--width >= 0);
 #else
-#define SPANSIZE 16
-#define INVSPAN	0.0625f
+	spansize = ds_tiltspansize;
+	invspan = 1.0/spansize;
 
 	startz = 1.f/iz;
 	startu = uz*startz;
 	startv = vz*startz;
 
-	izstep = ds_sz.x * SPANSIZE;
-	uzstep = ds_su.x * SPANSIZE;
-	vzstep = ds_sv.x * SPANSIZE;
+	izstep = ds_sz.x * spansize;
+	uzstep = ds_su.x * spansize;
+	vzstep = ds_sv.x * spansize;
 	//x1 = 0;
 	width++;
 
-	while (width >= SPANSIZE)
+	while (width >= spansize)
 	{
 		iz += izstep;
 		uz += uzstep;
@@ -998,12 +1041,12 @@ void R_DrawTiltedSplat_8(void)
 		endz = 1.f/iz;
 		endu = uz*endz;
 		endv = vz*endz;
-		stepu = (INT64)((endu - startu) * INVSPAN);
-		stepv = (INT64)((endv - startv) * INVSPAN);
+		stepu = (INT64)((endu - startu) * invspan);
+		stepv = (INT64)((endv - startv) * invspan);
 		u = (INT64)(startu) + viewx;
 		v = (INT64)(startv) + viewy;
 
-		for (i = SPANSIZE-1; i >= 0; i--)
+		for (i = spansize-1; i >= 0; i--)
 		{
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 			val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
@@ -1015,14 +1058,14 @@ void R_DrawTiltedSplat_8(void)
 		}
 		startu = endu;
 		startv = endv;
-		width -= SPANSIZE;
+		width -= spansize;
 	}
 	if (width > 0)
 	{
 		if (width == 1)
 		{
-			u = (INT64)(startu);
-			v = (INT64)(startv);
+			u = (INT64)(startu) + viewx;
+			v = (INT64)(startv) + viewy;
 			colormap = planezlight[tiltlighting[ds_x1++]] + (ds_colormap - colormaps);
 			val = source[((v >> nflatyshift) & nflatmask) | (u >> nflatxshift)];
 			if (val != TRANSPARENTPIXEL)
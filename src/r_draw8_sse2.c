@@ -0,0 +1,209 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1999-2018 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_draw8_sse2.c
+/// \brief 8bpp span drawers using SSE2
+/// \note  no includes because this is included as part of r_draw.c
+///        These must draw exactly the same pixels as their r_draw8.c
+///        counterparts; SCR_SetMode only picks them when the CPU has SSE2.
+
+// ==========================================================================
+// SPANS
+// ==========================================================================
+
+// Texture coordinates for 16 pixels are stepped and turned into flat
+// offsets four at a time in SSE registers. The palette lookups themselves
+// are still byte loads, since there's no byte gather, but the results are
+// written back with a single 16 byte store.
+
+#define SPANPIXELS 16
+
+typedef union
+{
+	__m128i v[SPANPIXELS/4];
+	UINT32 i[SPANPIXELS];
+} spanspots_t;
+
+typedef union
+{
+	__m128i v;
+	UINT8 b[SPANPIXELS];
+} spanpixels_t;
+
+/**	\brief Works out the flat offsets of the next SPANPIXELS pixels
+	and advances the positions past them.
+*/
+static inline void R_SpanSpots_SSE2(spanspots_t *spot, __m128i *xpos, __m128i *ypos,
+	__m128i xinc, __m128i yinc, __m128i xshift, __m128i yshift, __m128i mask)
+{
+	INT32 k;
+	for (k = 0; k < SPANPIXELS/4; k++)
+	{
+		spot->v[k] = _mm_or_si128(_mm_and_si128(_mm_srl_epi32(*ypos, yshift), mask),
+			_mm_srl_epi32(*xpos, xshift));
+		*xpos = _mm_add_epi32(*xpos, xinc);
+		*ypos = _mm_add_epi32(*ypos, yinc);
+	}
+}
+
+#define SPANSETUP_SSE2 \
+	__m128i xpos = _mm_setr_epi32(xposition, xposition + xstep, xposition + 2*xstep, xposition + 3*xstep); \
+	__m128i ypos = _mm_setr_epi32(yposition, yposition + ystep, yposition + 2*ystep, yposition + 3*ystep); \
+	const __m128i xinc = _mm_set1_epi32(xstep*4), yinc = _mm_set1_epi32(ystep*4); \
+	const __m128i xshift = _mm_cvtsi32_si128(nflatxshift), yshift = _mm_cvtsi32_si128(nflatyshift); \
+	const __m128i mask = _mm_set1_epi32(nflatmask); \
+	spanspots_t spot; \
+	spanpixels_t pix; \
+	INT32 k
+
+#define SPANFINISH_SSE2 \
+	xposition = (UINT32)_mm_cvtsi128_si32(xpos); \
+	yposition = (UINT32)_mm_cvtsi128_si32(ypos)
+
+/**	\brief The R_DrawSpan_8_SSE2 function
+	SSE2 version of R_DrawSpan_8.
+*/
+void R_DrawSpan_8_SSE2(void)
+{
+	UINT32 xposition;
+	UINT32 yposition;
+	UINT32 xstep, ystep;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+	const UINT8 *deststop = screens[0] + vid.rowbytes * vid.height;
+
+	size_t count;
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	source = ds_source;
+	colormap = ds_colormap;
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (dest+8 > deststop)
+		return;
+
+	if (count >= SPANPIXELS)
+	{
+		SPANSETUP_SSE2;
+
+		do
+		{
+			R_SpanSpots_SSE2(&spot, &xpos, &ypos, xinc, yinc, xshift, yshift, mask);
+			for (k = 0; k < SPANPIXELS; k++)
+				pix.b[k] = colormap[source[spot.i[k]]];
+			_mm_storeu_si128((__m128i *)dest, pix.v);
+
+			dest += SPANPIXELS;
+			count -= SPANPIXELS;
+		} while (count >= SPANPIXELS);
+
+		SPANFINISH_SSE2;
+	}
+
+	while (count-- && dest <= deststop)
+	{
+		*dest++ = colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]];
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+/**	\brief The R_DrawTranslucentSpan_8_SSE2 function
+	SSE2 version of R_DrawTranslucentSpan_8.
+*/
+void R_DrawTranslucentSpan_8_SSE2(void)
+{
+	UINT32 xposition;
+	UINT32 yposition;
+	UINT32 xstep, ystep;
+
+	UINT8 *source;
+	UINT8 *colormap;
+	UINT8 *dest;
+
+	size_t count;
+
+	xposition = ds_xfrac << nflatshiftup; yposition = ds_yfrac << nflatshiftup;
+	xstep = ds_xstep << nflatshiftup; ystep = ds_ystep << nflatshiftup;
+
+	source = ds_source;
+	colormap = ds_colormap;
+	dest = ylookup[ds_y] + columnofs[ds_x1];
+	count = ds_x2 - ds_x1 + 1;
+
+	if (count >= SPANPIXELS)
+	{
+		SPANSETUP_SSE2;
+
+		do
+		{
+			R_SpanSpots_SSE2(&spot, &xpos, &ypos, xinc, yinc, xshift, yshift, mask);
+			pix.v = _mm_loadu_si128((const __m128i *)dest);
+			for (k = 0; k < SPANPIXELS; k++)
+				pix.b[k] = *(ds_transmap + (colormap[source[spot.i[k]]] << 8) + pix.b[k]);
+			_mm_storeu_si128((__m128i *)dest, pix.v);
+
+			dest += SPANPIXELS;
+			count -= SPANPIXELS;
+		} while (count >= SPANPIXELS);
+
+		SPANFINISH_SSE2;
+	}
+
+	while (count--)
+	{
+		*dest = *(ds_transmap + (colormap[source[((yposition >> nflatyshift) & nflatmask) | (xposition >> nflatxshift)]] << 8) + *dest);
+		dest++;
+		xposition += xstep;
+		yposition += ystep;
+	}
+}
+
+/**	\brief The R_DrawFogSpan_8_SSE2 function
+	SSE2 version of R_DrawFogSpan_8.
+*/
+void R_DrawFogSpan_8_SSE2(void)
+{
+	UINT8 *colormap;
+	UINT8 *dest;
+	spanpixels_t pix;
+	INT32 k;
+
+	size_t count;
+
+	colormap = ds_colormap;
+	dest = &topleft[ds_y *vid.width + ds_x1];
+
+	count = ds_x2 - ds_x1 + 1;
+
+	while (count >= SPANPIXELS)
+	{
+		pix.v = _mm_loadu_si128((const __m128i *)dest);
+		for (k = 0; k < SPANPIXELS; k++)
+			pix.b[k] = colormap[pix.b[k]];
+		_mm_storeu_si128((__m128i *)dest, pix.v);
+
+		dest += SPANPIXELS;
+		count -= SPANPIXELS;
+	}
+
+	while (count--)
+	{
+		*dest = colormap[*dest];
+		dest++;
+	}
+}
+
+#undef SPANSETUP_SSE2
+#undef SPANFINISH_SSE2
+#undef SPANPIXELS
@@ -0,0 +1,493 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1999-2018 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_fps.c
+/// \brief Uncapped framerate, by interpolating what is drawn between game tics
+///        The game still only ticks at TICRATE. At the start of every tic the
+///        positions of everything that can move are remembered, and frames
+///        drawn in between blend from those to the current ones. The blended
+///        values are only in place while the view is drawn, so nothing the
+///        game simulates ever sees them.
+
+#include "doomdef.h"
+#include "doomstat.h"
+#include "console.h"
+#include "g_game.h"
+#include "i_system.h"
+#include "i_video.h" // rendermode
+#include "p_local.h"
+#include "p_polyobj.h"
+#include "r_fps.h"
+#include "r_main.h"
+#include "r_state.h"
+#include "z_zone.h"
+
+static CV_PossibleValue_t fpscap_cons_t[] = {{0, "MIN"}, {1000, "MAX"}, {0, NULL}};
+
+consvar_t cv_frameinterpolation = {"frameinterpolation", "Off", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+// Frames per second to stop at when interpolating; 0 draws as often as possible
+consvar_t cv_fpscap = {"fpscap", "0", CV_SAVE, fpscap_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+fixed_t rendertimefrac = FRACUNIT;
+
+// Anything that moves further than this in one tic was teleported,
+// and is drawn where it is rather than sliding across the map.
+#define MAXINTERPOLATEMOVE (512*FRACUNIT)
+
+static precise_t lasttictime = 0;
+static boolean interpolating = false;
+
+typedef struct
+{
+	fixed_t x, y, z;
+	angle_t angle, aiming;
+} viewstate_t;
+
+// Positions as of the start of the tic
+static fixed_t *oldsectorheights = NULL; // floor, ceiling pairs
+static size_t numoldsectors = 0;
+#ifdef POLYOBJECTS
+static fixed_t *oldpolyverts = NULL; // x, y pairs
+static size_t numoldpolyverts = 0;
+#endif
+static fixed_t oldviewz[MAXPLAYERS];
+static viewstate_t oldcamera[2];
+
+// Real positions of whatever R_BeginInterpolatedFrame moved
+typedef struct
+{
+	mobj_t *mo;
+	fixed_t x, y, z;
+	angle_t angle;
+} mobjrestore_t;
+
+static mobjrestore_t *mobjrestore = NULL;
+static size_t nummobjrestore = 0, maxmobjrestore = 0;
+static size_t *sectorrestore = NULL; // indexes into sectors[]
+static fixed_t *realsectorheights = NULL;
+static size_t numsectorrestore = 0;
+#ifdef POLYOBJECTS
+static fixed_t *realpolyverts = NULL;
+#endif
+static fixed_t realviewz[MAXPLAYERS];
+static viewstate_t realcamera[2];
+
+// ==========================================================================
+//                              HELPERS
+// ==========================================================================
+
+static boolean R_TooFarToInterpolate(fixed_t from, fixed_t to)
+{
+	INT64 d = (INT64)to - from;
+	return (d > MAXINTERPOLATEMOVE || d < -MAXINTERPOLATEMOVE);
+}
+
+static fixed_t R_LerpFixed(fixed_t from, fixed_t to)
+{
+	return from + FixedMul(rendertimefrac, to - from);
+}
+
+static angle_t R_LerpAngle(angle_t from, angle_t to)
+{
+	// Take the short way round
+	return from + (angle_t)FixedMul(rendertimefrac, (INT32)(to - from));
+}
+
+static boolean R_FrameInterpolationActive(void)
+{
+	return (cv_frameinterpolation.value && !dedicated && !singletics
+		&& rendermode != render_none && gamestate == GS_LEVEL
+		&& !(paused || P_AutoPause()));
+}
+
+static void R_SaveViewState(viewstate_t *vs, const camera_t *cam)
+{
+	vs->x = cam->x;
+	vs->y = cam->y;
+	vs->z = cam->z;
+	vs->angle = cam->angle;
+	vs->aiming = cam->aiming;
+}
+
+static void R_LoadViewState(camera_t *cam, const viewstate_t *vs)
+{
+	cam->x = vs->x;
+	cam->y = vs->y;
+	cam->z = vs->z;
+	cam->angle = vs->angle;
+	cam->aiming = vs->aiming;
+}
+
+// Only lightlists depend on sector heights in the renderer, and only
+// sectors with 3D floors have one: the sector itself, if it has any, and
+// the targets of any 3D floor it controls.
+static void R_MarkLightListsMoved(sector_t *sec)
+{
+	size_t i;
+
+	if (sec->ffloors)
+		sec->moved = true;
+	for (i = 0; i < sec->numattached; i++)
+		sectors[sec->attached[i]].moved = true;
+}
+
+#ifdef POLYOBJECTS
+static size_t R_CountPolyVerts(void)
+{
+	size_t count = 0;
+	INT32 i;
+
+	for (i = 0; i < numPolyObjects; i++)
+		count += PolyObjects[i].numVertices;
+	return count;
+}
+#endif
+
+// ==========================================================================
+//                              TIC STATE
+// ==========================================================================
+
+//
+// R_SaveInterpolationState
+//
+void R_SaveInterpolationState(void)
+{
+	thinker_t *th;
+	mobj_t *mo;
+	size_t i;
+	INT32 p;
+
+	if (dedicated)
+		return;
+
+	lasttictime = I_GetPreciseTime();
+
+	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	{
+		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+			continue;
+
+		mo = (mobj_t *)th;
+		mo->old_x = mo->x;
+		mo->old_y = mo->y;
+		mo->old_z = mo->z;
+		mo->old_angle = mo->angle;
+	}
+
+	if (numoldsectors != numsectors)
+	{
+		oldsectorheights = Z_Realloc(oldsectorheights, numsectors * 2 * sizeof (*oldsectorheights), PU_STATIC, NULL);
+		realsectorheights = Z_Realloc(realsectorheights, numsectors * 2 * sizeof (*realsectorheights), PU_STATIC, NULL);
+		sectorrestore = Z_Realloc(sectorrestore, numsectors * sizeof (*sectorrestore), PU_STATIC, NULL);
+		numoldsectors = numsectors;
+	}
+	for (i = 0; i < numsectors; i++)
+	{
+		oldsectorheights[i*2] = sectors[i].floorheight;
+		oldsectorheights[i*2 + 1] = sectors[i].ceilingheight;
+	}
+
+#ifdef POLYOBJECTS
+	{
+		size_t count = R_CountPolyVerts(), v;
+		INT32 po;
+
+		if (numoldpolyverts != count)
+		{
+			oldpolyverts = Z_Realloc(oldpolyverts, count * 2 * sizeof (*oldpolyverts), PU_STATIC, NULL);
+			realpolyverts = Z_Realloc(realpolyverts, count * 2 * sizeof (*realpolyverts), PU_STATIC, NULL);
+			numoldpolyverts = count;
+		}
+		for (po = 0, i = 0; po < numPolyObjects; po++)
+			for (v = 0; v < PolyObjects[po].numVertices; v++, i++)
+			{
+				oldpolyverts[i*2] = PolyObjects[po].vertices[v]->x;
+				oldpolyverts[i*2 + 1] = PolyObjects[po].vertices[v]->y;
+			}
+	}
+#endif
+
+	for (p = 0; p < MAXPLAYERS; p++)
+		oldviewz[p] = players[p].viewz;
+	R_SaveViewState(&oldcamera[0], &camera);
+	R_SaveViewState(&oldcamera[1], &camera2);
+}
+
+// ==========================================================================
+//                              DRAWING
+// ==========================================================================
+
+//
+// R_BeginInterpolatedFrame
+//
+void R_BeginInterpolatedFrame(void)
+{
+	thinker_t *th;
+	mobj_t *mo;
+	size_t i;
+	INT32 p;
+	INT64 elapsed;
+
+	rendertimefrac = FRACUNIT;
+
+	// Lightlists built during the last frame used blended heights.
+	// The ones that are blended again below get rebuilt anyway.
+	for (i = 0; i < numsectorrestore; i++)
+		if (sectorrestore[i] < numsectors)
+			R_MarkLightListsMoved(&sectors[sectorrestore[i]]);
+	numsectorrestore = 0;
+
+	if (!R_FrameInterpolationActive() || numoldsectors != numsectors)
+		return;
+
+	elapsed = (INT64)I_PreciseToMicros(I_GetPreciseTime() - lasttictime) * TICRATE;
+	if (elapsed >= 1000000)
+		return; // the latest tic is exactly what should be on screen
+	rendertimefrac = (fixed_t)(elapsed * FRACUNIT / 1000000);
+
+	interpolating = true;
+
+	// Things
+	nummobjrestore = 0;
+	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	{
+		if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+			continue;
+
+		mo = (mobj_t *)th;
+		if (mo->x == mo->old_x && mo->y == mo->old_y && mo->z == mo->old_z && mo->angle == mo->old_angle)
+			continue;
+		if (R_TooFarToInterpolate(mo->old_x, mo->x) || R_TooFarToInterpolate(mo->old_y, mo->y)
+			|| R_TooFarToInterpolate(mo->old_z, mo->z))
+			continue;
+
+		if (nummobjrestore >= maxmobjrestore)
+		{
+			maxmobjrestore = maxmobjrestore ? maxmobjrestore*2 : 256;
+			mobjrestore = Z_Realloc(mobjrestore, maxmobjrestore * sizeof (*mobjrestore), PU_STATIC, NULL);
+		}
+		mobjrestore[nummobjrestore].mo = mo;
+		mobjrestore[nummobjrestore].x = mo->x;
+		mobjrestore[nummobjrestore].y = mo->y;
+		mobjrestore[nummobjrestore].z = mo->z;
+		mobjrestore[nummobjrestore].angle = mo->angle;
+		nummobjrestore++;
+
+		mo->x = R_LerpFixed(mo->old_x, mo->x);
+		mo->y = R_LerpFixed(mo->old_y, mo->y);
+		mo->z = R_LerpFixed(mo->old_z, mo->z);
+		mo->angle = R_LerpAngle(mo->old_angle, mo->angle);
+	}
+
+	// Moving floors and ceilings, including FOF control sectors
+	for (i = 0; i < numsectors; i++)
+	{
+		sector_t *sec = &sectors[i];
+		if (sec->floorheight == oldsectorheights[i*2] && sec->ceilingheight == oldsectorheights[i*2 + 1])
+			continue;
+
+		realsectorheights[numsectorrestore*2] = sec->floorheight;
+		realsectorheights[numsectorrestore*2 + 1] = sec->ceilingheight;
+		sectorrestore[numsectorrestore++] = i;
+
+		sec->floorheight = R_LerpFixed(oldsectorheights[i*2], sec->floorheight);
+		sec->ceilingheight = R_LerpFixed(oldsectorheights[i*2 + 1], sec->ceilingheight);
+		R_MarkLightListsMoved(sec);
+	}
+
+#ifdef POLYOBJECTS
+	if (numoldpolyverts == R_CountPolyVerts())
+	{
+		size_t v;
+		INT32 po;
+
+		for (po = 0, i = 0; po < numPolyObjects; po++)
+			for (v = 0; v < PolyObjects[po].numVertices; v++, i++)
+			{
+				vertex_t *vert = PolyObjects[po].vertices[v];
+				realpolyverts[i*2] = vert->x;
+				realpolyverts[i*2 + 1] = vert->y;
+				vert->x = R_LerpFixed(oldpolyverts[i*2], vert->x);
+				vert->y = R_LerpFixed(oldpolyverts[i*2 + 1], vert->y);
+			}
+	}
+#endif
+
+	// Views
+	for (p = 0; p < MAXPLAYERS; p++)
+	{
+		realviewz[p] = players[p].viewz;
+		if (playeringame[p] && !R_TooFarToInterpolate(oldviewz[p], players[p].viewz))
+			players[p].viewz = R_LerpFixed(oldviewz[p], players[p].viewz);
+	}
+
+	R_SaveViewState(&realcamera[0], &camera);
+	R_SaveViewState(&realcamera[1], &camera2);
+	if (!R_TooFarToInterpolate(oldcamera[0].x, camera.x) && !R_TooFarToInterpolate(oldcamera[0].y, camera.y))
+	{
+		camera.x = R_LerpFixed(oldcamera[0].x, camera.x);
+		camera.y = R_LerpFixed(oldcamera[0].y, camera.y);
+		camera.z = R_LerpFixed(oldcamera[0].z, camera.z);
+		camera.angle = R_LerpAngle(oldcamera[0].angle, camera.angle);
+		camera.aiming = R_LerpAngle(oldcamera[0].aiming, camera.aiming);
+	}
+	if (splitscreen && !R_TooFarToInterpolate(oldcamera[1].x, camera2.x) && !R_TooFarToInterpolate(oldcamera[1].y, camera2.y))
+	{
+		camera2.x = R_LerpFixed(oldcamera[1].x, camera2.x);
+		camera2.y = R_LerpFixed(oldcamera[1].y, camera2.y);
+		camera2.z = R_LerpFixed(oldcamera[1].z, camera2.z);
+		camera2.angle = R_LerpAngle(oldcamera[1].angle, camera2.angle);
+		camera2.aiming = R_LerpAngle(oldcamera[1].aiming, camera2.aiming);
+	}
+}
+
+//
+// R_InterpolatingFrame
+//
+boolean R_InterpolatingFrame(void)
+{
+	return interpolating;
+}
+
+//
+// R_EndInterpolatedFrame
+//
+void R_EndInterpolatedFrame(void)
+{
+	size_t i;
+	INT32 p;
+
+	if (!interpolating)
+		return;
+	interpolating = false;
+
+	for (i = 0; i < nummobjrestore; i++)
+	{
+		mobj_t *mo = mobjrestore[i].mo;
+		mo->x = mobjrestore[i].x;
+		mo->y = mobjrestore[i].y;
+		mo->z = mobjrestore[i].z;
+		mo->angle = mobjrestore[i].angle;
+	}
+
+	for (i = 0; i < numsectorrestore; i++)
+	{
+		sector_t *sec = &sectors[sectorrestore[i]];
+		sec->floorheight = realsectorheights[i*2];
+		sec->ceilingheight = realsectorheights[i*2 + 1];
+	}
+
+#ifdef POLYOBJECTS
+	if (numoldpolyverts == R_CountPolyVerts())
+	{
+		size_t v;
+		INT32 po;
+
+		for (po = 0, i = 0; po < numPolyObjects; po++)
+			for (v = 0; v < PolyObjects[po].numVertices; v++, i++)
+			{
+				PolyObjects[po].vertices[v]->x = realpolyverts[i*2];
+				PolyObjects[po].vertices[v]->y = realpolyverts[i*2 + 1];
+			}
+	}
+#endif
+
+	for (p = 0; p < MAXPLAYERS; p++)
+		players[p].viewz = realviewz[p];
+	R_LoadViewState(&camera, &realcamera[0]);
+	R_LoadViewState(&camera2, &realcamera[1]);
+}
+
+// ==========================================================================
+//                              FRAME PACING
+// ==========================================================================
+
+#define FRAMESAMPLES 256
+
+static precise_t lastframetime = 0;
+static INT32 frametimes[FRAMESAMPLES]; // microseconds between frames
+static size_t numframetimes = 0, nextframetime = 0;
+
+//
+// R_InterpolatedFrameDue
+//
+boolean R_InterpolatedFrameDue(void)
+{
+	precise_t now;
+
+	if (!R_FrameInterpolationActive())
+		return false;
+
+	// Once a whole tic has gone by, every frame until the next one would
+	// be the same as the last, so wait for the tic instead.
+	now = I_GetPreciseTime();
+	if ((INT64)I_PreciseToMicros(now - lasttictime) * TICRATE >= 1000000)
+		return false;
+
+	if (!cv_fpscap.value)
+		return true;
+	return (I_PreciseToMicros(now - lastframetime) >= 1000000 / cv_fpscap.value);
+}
+
+//
+// R_RecordFrameTime
+// Called once for every frame drawn.
+//
+void R_RecordFrameTime(void)
+{
+	precise_t now = I_GetPreciseTime();
+
+	if (lastframetime)
+	{
+		frametimes[nextframetime] = I_PreciseToMicros(now - lastframetime);
+		nextframetime = (nextframetime + 1) % FRAMESAMPLES;
+		if (numframetimes < FRAMESAMPLES)
+			numframetimes++;
+	}
+	lastframetime = now;
+}
+
+static int R_CompareFrameTimes(const void *a, const void *b)
+{
+	INT32 ta = *(const INT32 *)a, tb = *(const INT32 *)b;
+	return (ta > tb) - (ta < tb);
+}
+
+//
+// Command_FrameStats_f
+// Prints how evenly the last few hundred frames were paced.
+//
+void Command_FrameStats_f(void)
+{
+	INT32 sorted[FRAMESAMPLES];
+	INT64 total = 0;
+	size_t i;
+
+	if (!numframetimes)
+	{
+		CONS_Printf(M_GetText("No frames drawn yet.\n"));
+		return;
+	}
+
+	for (i = 0; i < numframetimes; i++)
+	{
+		sorted[i] = frametimes[i];
+		total += frametimes[i];
+	}
+	qsort(sorted, numframetimes, sizeof (*sorted), R_CompareFrameTimes);
+	if (total <= 0)
+		total = 1;
+
+	CONS_Printf(M_GetText("Last %s frames (interpolation %s, cap %d):\n"), sizeu1(numframetimes),
+		cv_frameinterpolation.value ? M_GetText("on") : M_GetText("off"), cv_fpscap.value);
+	CONS_Printf(M_GetText("Average: %d.%d fps, %d us per frame\n"),
+		(INT32)((INT64)numframetimes * 1000000 / total), (INT32)((INT64)numframetimes * 10000000 / total % 10),
+		(INT32)(total / numframetimes));
+	CONS_Printf(M_GetText("Best %d us, median %d us, 99th percentile %d us, worst %d us\n"),
+		sorted[0], sorted[numframetimes/2], sorted[numframetimes*99/100], sorted[numframetimes-1]);
+}
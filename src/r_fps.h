@@ -0,0 +1,43 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1999-2018 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_fps.h
+/// \brief Uncapped framerate, by interpolating what is drawn between game tics
+
+#ifndef __R_FPS__
+#define __R_FPS__
+
+#include "m_fixed.h"
+#include "command.h"
+
+extern consvar_t cv_frameinterpolation, cv_fpscap;
+
+// How far the frame being drawn is from the previous tic (0) to the latest (FRACUNIT)
+extern fixed_t rendertimefrac;
+
+// Remembers where everything is at the start of a tic, and when it started.
+// Also called after loading a level or a netgame, so nothing slides into place.
+void R_SaveInterpolationState(void);
+
+// True when D_SRB2Loop should draw another frame even though no tic ran
+boolean R_InterpolatedFrameDue(void);
+
+// Moves mobjs, the view, sector heights and polyobjects to where they are
+// rendertimefrac of the way through the current tic, and puts them back.
+// Everything between the two must only draw.
+void R_BeginInterpolatedFrame(void);
+void R_EndInterpolatedFrame(void);
+
+// True between the two, while the blended positions are in place
+boolean R_InterpolatingFrame(void);
+
+// Frame pacing
+void R_RecordFrameTime(void);
+void Command_FrameStats_f(void);
+
+#endif
@@ -19,6 +19,7 @@
 #include "r_local.h"
 #include "r_splats.h" // faB(21jan): testing
 #include "r_sky.h"
+#include "r_fps.h"
 #include "st_stuff.h"
 #include "p_local.h"
 #include "keys.h"
@@ -28,8 +29,12 @@
 #include "d_main.h"
 #include "v_video.h"
 #include "p_spec.h" // skyboxmo
+#include "p_slopes.h" // slopestats
 #include "z_zone.h"
 #include "m_random.h" // quake camera shake
+#include "m_misc.h" // FIL_ReadFile
+#include "p_setup.h" // mapthings
+#include "i_system.h" // I_GetPreciseTime
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -66,7 +71,20 @@ fixed_t viewx, viewy, viewz;
 angle_t viewangle, aimingangle;
 fixed_t viewcos, viewsin;
 boolean viewsky, skyVisible;
-boolean skyVisible1, skyVisible2; // saved values of skyVisible for P1 and P2, for splitscreen
+
+viewcontext_t viewcontexts[2];
+viewcontext_t *curview = &viewcontexts[0];
+
+// Set by renderbench to draw from there instead of wherever the player is
+static camera_t *benchcam = NULL;
+
+boolean rendertimers = false;
+precise_t rendertime[NUMRENDERTIMERS];
+const char *const rendertimernames[NUMRENDERTIMERS] = {"bsp", "portals", "segs", "planes", "sprites", "drawnodes", "masked", "postprocess"};
+static precise_t rendertimetotal; // all of rendertime added together
+precise_t portaltimemax;
+UINT32 rendercount[NUMRENDERCOUNTERS];
+const char *const rendercounternames[NUMRENDERCOUNTERS] = {"visplanes", "drawsegs", "vissprites", "drawnodes", "portals", "spans", "columns"};
 sector_t *viewsector;
 player_t *viewplayer;
 
@@ -91,11 +109,19 @@ typedef struct portal_pair
 	INT16 *ceilingclip;
 	INT16 *floorclip;
 	fixed_t *frontscale;
+	INT32 clipwidth; // how many columns the clip arrays have room for
 } portal_pair;
 portal_pair *portal_base, *portal_cap;
 line_t *portalclipline;
 INT32 portalclipstart, portalclipend;
 
+// Portals are kept from frame to frame instead of being allocated for
+// each one found, and only grow their clip arrays when they have to.
+static portal_pair **portalpool;
+static INT32 portalpoolsize, numportals;
+static INT32 portalpixels; // open pixels behind the portals this frame
+INT32 portalsrendered;
+
 //
 // precalculated math tables
 //
@@ -129,12 +155,18 @@ static CV_PossibleValue_t drawdist_cons_t[] = {
 static CV_PossibleValue_t precipdensity_cons_t[] = {{0, "None"}, {1, "Light"}, {2, "Moderate"}, {4, "Heavy"}, {6, "Thick"}, {8, "V.Thick"}, {0, NULL}};
 static CV_PossibleValue_t translucenthud_cons_t[] = {{0, "MIN"}, {10, "MAX"}, {0, NULL}};
 static CV_PossibleValue_t maxportals_cons_t[] = {{0, "MIN"}, {12, "MAX"}, {0, NULL}}; // lmao rendering 32 portals, you're a card
+static CV_PossibleValue_t portalbudget_cons_t[] = {{0, "MIN"}, {1000, "MAX"}, {0, NULL}};
 static CV_PossibleValue_t homremoval_cons_t[] = {{0, "No"}, {1, "Yes"}, {2, "Flash"}, {0, NULL}};
+static CV_PossibleValue_t renderthreads_cons_t[] = {{1, "MIN"}, {MAXRENDERTHREADS, "MAX"}, {0, NULL}};
+#ifdef ESLOPE
+static CV_PossibleValue_t slopespansize_cons_t[] = {{1, "MIN"}, {64, "MAX"}, {0, NULL}};
+#endif
 
 static void ChaseCam_OnChange(void);
 static void ChaseCam2_OnChange(void);
 static void FlipCam_OnChange(void);
 static void FlipCam2_OnChange(void);
+static void RenderStats_OnChange(void);
 void SendWeaponPref(void);
 void SendWeaponPref2(void);
 
@@ -162,6 +194,22 @@ consvar_t cv_precipdensity = {"precipdensity", "Moderate", CV_SAVE, precipdensit
 consvar_t cv_homremoval = {"homremoval", "No", CV_SAVE, homremoval_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
 consvar_t cv_maxportals = {"maxportals", "2", CV_SAVE, maxportals_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+// percent of the view's pixels that may be drawn through portals, 0 for no limit
+consvar_t cv_portalbudget = {"portalbudget", "0", CV_SAVE, portalbudget_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+// Threads to draw software renderer walls with
+consvar_t cv_renderthreads = {"renderthreads", "1", CV_SAVE, renderthreads_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+#ifdef ESLOPE
+// Pixels between perspective divides on sloped planes; 1 divides at every pixel
+consvar_t cv_slopespansize = {"slopespansize", "16", CV_SAVE, slopespansize_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+#endif
+
+// Draw far away walls and floors with smaller copies of their textures
+consvar_t cv_texturemips = {"texturemips", "On", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+
+// Time every frame, and show where the time went
+consvar_t cv_renderstats = {"renderstats", "Off", CV_CALL, CV_OnOff, RenderStats_OnChange, 0, NULL, NULL, 0, 0, NULL};
 
 void SplitScreen_OnChange(void)
 {
@@ -737,6 +785,260 @@ subsector_t *R_IsPointInSubsector(fixed_t x, fixed_t y)
 	return ret;
 }
 
+//
+// Subsector locality hints
+//
+// Every BSP node and subsector covers a convex region of the map, cut out by
+// the partition lines of its ancestors. Most of those partitions are far away
+// from the region itself, so only the few that actually touch it need to be
+// tested to know whether a point is inside. R_PointInSubsectorHint uses that
+// to confirm a moving object is still in its old subsector (or under one of
+// that subsector's parent nodes) without walking down from the root.
+//
+// The partitions that are kept are tested with R_PointOnSide, exactly like
+// the full walk does, and the ones that are dropped are at least
+// SSHINT_SLACK away from every corner of the region. So the answer is always
+// the same subsector R_PointInSubsector would have returned.
+//
+
+#define SSHINT_NONE 0xFFFF // region is degenerate, never trust it
+#define SSHINT_MAXDEPTH 256 // deeper trees than this are not hinted
+#define SSHINT_MAXVERTS 64
+#define SSHINT_MAXCLIMB 2 // parent nodes to try before walking from the root
+#define SSHINT_SLACK 16.0 // in map units
+
+typedef struct
+{
+	size_t first; // into sshintchecks
+	UINT16 count; // or SSHINT_NONE
+	INT32 parent; // node number, -1 for the root
+} sshintregion_t;
+
+// numnodes regions for nodes, then numsubsectors regions for subsectors
+static sshintregion_t *sshintregions = NULL;
+// (node number << 1) | side, for each partition a region has to be checked against
+static UINT16 *sshintchecks = NULL;
+
+static struct
+{
+	UINT32 leafhits; // still in the hinted subsector
+	UINT32 nodehits; // found by descending from one of its parent nodes
+	UINT32 walks; // full walk from the root
+} sshintstats;
+
+// Keeps the side of a convex polygon where R_PointOnSide(node) == side.
+static INT32 R_ClipHintPolygon(const double *in, INT32 numin, double *out, const node_t *node, INT32 side)
+{
+	const double nx = (double)node->x/FRACUNIT, ny = (double)node->y/FRACUNIT;
+	const double dx = (double)node->dx/FRACUNIT, dy = (double)node->dy/FRACUNIT;
+	double d1, d2;
+	INT32 i, numout = 0;
+
+	for (i = 0; i < numin; i++)
+	{
+		const double *v1 = &in[i*2];
+		const double *v2 = &in[((i+1) % numin)*2];
+
+		// positive means side 1 (back)
+		d1 = (v1[1] - ny)*dx - dy*(v1[0] - nx);
+		d2 = (v2[1] - ny)*dx - dy*(v2[0] - nx);
+		if (!side)
+			d1 = -d1, d2 = -d2;
+
+		if (numout + 2 > SSHINT_MAXVERTS)
+			return 0;
+
+		if (d1 >= 0)
+		{
+			out[numout*2] = v1[0];
+			out[numout*2 + 1] = v1[1];
+			numout++;
+		}
+		if ((d1 >= 0) != (d2 >= 0))
+		{
+			const double frac = d1/(d1 - d2);
+			out[numout*2] = v1[0] + (v2[0] - v1[0])*frac;
+			out[numout*2 + 1] = v1[1] + (v2[1] - v1[1])*frac;
+			numout++;
+		}
+	}
+
+	return numout;
+}
+
+static void R_AddHintCheck(size_t *numchecks, size_t *maxchecks, UINT16 check)
+{
+	if (*numchecks >= *maxchecks)
+	{
+		*maxchecks = *maxchecks ? *maxchecks*2 : 1024;
+		sshintchecks = Z_Realloc(sshintchecks, *maxchecks * sizeof (*sshintchecks), PU_LEVEL, &sshintchecks);
+	}
+	sshintchecks[(*numchecks)++] = check;
+}
+
+//
+// R_BuildSubsectorHints
+// Works out which partitions bound each node and subsector.
+// Must be called after the nodes are loaded.
+//
+void R_BuildSubsectorHints(void)
+{
+	static double poly[2][SSHINT_MAXVERTS*2];
+	UINT16 path[SSHINT_MAXDEPTH];
+	size_t i, numregions = numnodes + numsubsectors;
+	size_t numchecks = 0, maxchecks = 0;
+	INT32 j, depth, numverts, cur;
+
+	memset(&sshintstats, 0, sizeof (sshintstats));
+	if (sshintregions)
+		Z_Free(sshintregions);
+	if (sshintchecks)
+		Z_Free(sshintchecks);
+
+	Z_Malloc(numregions * sizeof (*sshintregions), PU_LEVEL, &sshintregions);
+	for (i = 0; i < numregions; i++)
+		sshintregions[i].parent = -1;
+
+	for (i = 0; i < numnodes; i++)
+		for (j = 0; j < 2; j++)
+		{
+			UINT16 child = nodes[i].children[j];
+			if (child & NF_SUBSECTOR)
+				child = (UINT16)(numnodes + (child & ~NF_SUBSECTOR));
+			if (child < numregions)
+				sshintregions[child].parent = (INT32)i;
+		}
+
+	for (i = 0; i < numregions; i++)
+	{
+		sshintregion_t *region = &sshintregions[i];
+		size_t child = i;
+
+		region->first = numchecks;
+		region->count = SSHINT_NONE;
+
+		// Collect the partitions from here up to the root, with the side taken.
+		for (depth = 0; sshintregions[child].parent != -1 && depth < SSHINT_MAXDEPTH; depth++)
+		{
+			const INT32 parent = sshintregions[child].parent;
+			const UINT16 childnum = (child >= numnodes) ? (UINT16)((child - numnodes) | NF_SUBSECTOR) : (UINT16)child;
+			path[depth] = (UINT16)((parent << 1) | (nodes[parent].children[1] == childnum));
+			child = parent;
+		}
+		if (depth >= SSHINT_MAXDEPTH || child != numnodes - 1)
+			continue; // too deep, or not connected to the root
+
+		// Start from the whole fixed-point plane and cut it down.
+		poly[0][0] = -32768.0; poly[0][1] = -32768.0;
+		poly[0][2] =  32768.0; poly[0][3] = -32768.0;
+		poly[0][4] =  32768.0; poly[0][5] =  32768.0;
+		poly[0][6] = -32768.0; poly[0][7] =  32768.0;
+		numverts = 4;
+		cur = 0;
+
+		for (j = 0; j < depth && numverts >= 3; j++, cur ^= 1)
+			numverts = R_ClipHintPolygon(poly[cur], numverts, poly[cur^1], &nodes[path[j] >> 1], path[j] & 1);
+		if (numverts < 3)
+			continue;
+
+		region->count = 0;
+		for (j = 0; j < depth; j++)
+		{
+			const node_t *node = &nodes[path[j] >> 1];
+			const double nx = (double)node->x/FRACUNIT, ny = (double)node->y/FRACUNIT;
+			const double dx = (double)node->dx/FRACUNIT, dy = (double)node->dy/FRACUNIT;
+			const double len = sqrt(dx*dx + dy*dy);
+			INT32 v;
+
+			for (v = 0; v < numverts; v++)
+				if (fabs((poly[cur][v*2 + 1] - ny)*dx - dy*(poly[cur][v*2] - nx)) < SSHINT_SLACK*len)
+					break;
+			if (v == numverts)
+				continue; // nowhere near this region
+
+			R_AddHintCheck(&numchecks, &maxchecks, path[j]);
+			region->count++;
+		}
+	}
+
+	CONS_Debug(DBG_SETUP, "R_BuildSubsectorHints: %s checks for %s regions\n", sizeu1(numchecks), sizeu2(numregions));
+}
+
+static inline boolean R_PointInHintRegion(fixed_t x, fixed_t y, const sshintregion_t *region)
+{
+	const UINT16 *check = &sshintchecks[region->first];
+	UINT16 i;
+
+	if (region->count == SSHINT_NONE)
+		return false;
+
+	for (i = 0; i < region->count; i++, check++)
+		if (R_PointOnSide(x, y, &nodes[*check >> 1]) != (*check & 1))
+			return false;
+
+	return true;
+}
+
+//
+// R_PointInSubsectorHint
+// Same as R_PointInSubsector, but checks near a subsector the point
+// was last known to be in before walking the whole BSP.
+//
+subsector_t *R_PointInSubsectorHint(fixed_t x, fixed_t y, subsector_t *hint)
+{
+	size_t ssnum, nodenum;
+	INT32 region, climb;
+
+	// The hint may be left over from an earlier level (camera->subsector
+	// survives level changes), so only trust it if it really is one of ours.
+	ssnum = ((size_t)hint - (size_t)subsectors) / sizeof (subsector_t);
+	if (!sshintregions || !hint || ssnum >= numsubsectors || &subsectors[ssnum] != hint)
+	{
+		sshintstats.walks++;
+		return R_PointInSubsector(x, y);
+	}
+
+	if (R_PointInHintRegion(x, y, &sshintregions[numnodes + ssnum]))
+	{
+		sshintstats.leafhits++;
+		return hint;
+	}
+
+	region = sshintregions[numnodes + ssnum].parent;
+	for (climb = 0; region != -1 && climb < SSHINT_MAXCLIMB; climb++, region = sshintregions[region].parent)
+	{
+		if (!R_PointInHintRegion(x, y, &sshintregions[region]))
+			continue;
+
+		sshintstats.nodehits++;
+		nodenum = (size_t)region;
+		while (!(nodenum & NF_SUBSECTOR))
+			nodenum = nodes[nodenum].children[R_PointOnSide(x, y, nodes+nodenum)];
+		return &subsectors[nodenum & ~NF_SUBSECTOR];
+	}
+
+	sshintstats.walks++;
+	return R_PointInSubsector(x, y);
+}
+
+static void Command_SubsectorStats_f(void)
+{
+	const UINT32 total = sshintstats.leafhits + sshintstats.nodehits + sshintstats.walks;
+
+	if (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"))
+	{
+		memset(&sshintstats, 0, sizeof (sshintstats));
+		return;
+	}
+
+	CONS_Printf(M_GetText("Subsector lookups : %10u\n"), total);
+	if (!total)
+		return;
+	CONS_Printf(M_GetText("Same subsector    : %10u (%u%%)\n"), sshintstats.leafhits, (UINT32)((UINT64)sshintstats.leafhits*100/total));
+	CONS_Printf(M_GetText("Nearby node       : %10u (%u%%)\n"), sshintstats.nodehits, (UINT32)((UINT64)sshintstats.nodehits*100/total));
+	CONS_Printf(M_GetText("Full BSP walk     : %10u (%u%%)\n"), sshintstats.walks, (UINT32)((UINT64)sshintstats.walks*100/total));
+}
+
 //
 // R_SetupFrame
 //
@@ -771,6 +1073,23 @@ void R_SetupFrame(player_t *player, boolean skybox)
 	camera_t *thiscam;
 	boolean chasecam = false;
 
+	if (benchcam)
+	{
+		viewsky = !skybox;
+		viewmobj = NULL;
+		viewplayer = player;
+		viewx = benchcam->x;
+		viewy = benchcam->y;
+		viewz = benchcam->z;
+		viewangle = benchcam->angle;
+		aimingangle = benchcam->aiming;
+		viewsector = benchcam->subsector->sector;
+		viewsin = FINESINE(viewangle>>ANGLETOFINESHIFT);
+		viewcos = FINECOSINE(viewangle>>ANGLETOFINESHIFT);
+		R_SetupFreelook();
+		return;
+	}
+
 	if (splitscreen && player == &players[secondarydisplayplayer]
 		&& player != &players[consoleplayer])
 	{
@@ -878,7 +1197,9 @@ void R_SkyboxFrame(player_t *player)
 {
 	camera_t *thiscam;
 
-	if (splitscreen && player == &players[secondarydisplayplayer]
+	if (benchcam)
+		thiscam = benchcam;
+	else if (splitscreen && player == &players[secondarydisplayplayer]
 	&& player != &players[consoleplayer])
 		thiscam = &camera2;
 	else
@@ -894,7 +1215,7 @@ void R_SkyboxFrame(player_t *player)
 		I_Error("R_SkyboxFrame: viewmobj null (player %s)", sizeu1(playeri));
 	}
 #endif
-	if (player->awayviewtics)
+	if (player->awayviewtics && !benchcam)
 	{
 		aimingangle = player->awayviewaiming;
 		viewangle = player->awayviewmobj->angle;
@@ -939,7 +1260,7 @@ void R_SkyboxFrame(player_t *player)
 	if (mapheaderinfo[gamemap-1])
 	{
 		mapheader_t *mh = mapheaderinfo[gamemap-1];
-		if (player->awayviewtics)
+		if (player->awayviewtics && !benchcam)
 		{
 			if (skyboxmo[1])
 			{
@@ -1161,23 +1482,56 @@ static void R_PortalFrame(line_t *start, line_t *dest, portal_pair *portal)
 #endif
 }
 
-void R_AddPortal(INT32 line1, INT32 line2, INT32 x1, INT32 x2)
+//
+// R_AddPortal
+// Queues the view through line1 out of line2 to be rendered after this one.
+// Returns false if it would go over cv_portalbudget, and the line should be
+// drawn as a wall instead.
+//
+boolean R_AddPortal(INT32 line1, INT32 line2, INT32 x1, INT32 x2)
 {
-	portal_pair *portal = Z_Malloc(sizeof(portal_pair), PU_LEVEL, NULL);
-	INT16 *ceilingclipsave = Z_Malloc(sizeof(INT16)*(x2-x1), PU_LEVEL, NULL);
-	INT16 *floorclipsave = Z_Malloc(sizeof(INT16)*(x2-x1), PU_LEVEL, NULL);
-	fixed_t *frontscalesave = Z_Malloc(sizeof(fixed_t)*(x2-x1), PU_LEVEL, NULL);
+	portal_pair *portal;
+	INT32 x, pixels = 0;
+
+	// Only the rows still open in front of the portal can be seen through it
+	for (x = x1; x < x2; x++)
+		if (floorclip[x] - ceilingclip[x] > 1)
+			pixels += floorclip[x] - ceilingclip[x] - 1;
+
+	if (!pixels)
+	{
+		// Nothing behind it can show, so don't walk the tree for it
+		portalline = true;
+		return true;
+	}
+
+	if (cv_portalbudget.value && portalpixels + pixels > cv_portalbudget.value * viewwidth / 100 * viewheight)
+		return false;
+	portalpixels += pixels;
+
+	if (numportals == portalpoolsize)
+	{
+		portalpoolsize = portalpoolsize ? portalpoolsize * 2 : 8;
+		portalpool = Z_Realloc(portalpool, portalpoolsize * sizeof (*portalpool), PU_STATIC, NULL);
+		for (x = numportals; x < portalpoolsize; x++)
+			portalpool[x] = Z_Calloc(sizeof (portal_pair), PU_STATIC, NULL);
+	}
+	portal = portalpool[numportals++];
+
+	if (portal->clipwidth < x2-x1)
+	{
+		portal->clipwidth = x2-x1;
+		portal->ceilingclip = Z_Realloc(portal->ceilingclip, sizeof(INT16)*(x2-x1), PU_STATIC, NULL);
+		portal->floorclip = Z_Realloc(portal->floorclip, sizeof(INT16)*(x2-x1), PU_STATIC, NULL);
+		portal->frontscale = Z_Realloc(portal->frontscale, sizeof(fixed_t)*(x2-x1), PU_STATIC, NULL);
+	}
 
 	portal->line1 = line1;
 	portal->line2 = line2;
 	portal->pass = portalrender+1;
 	portal->next = NULL;
 
-	R_PortalStoreClipValues(x1, x2, ceilingclipsave, floorclipsave, frontscalesave);
-
-	portal->ceilingclip = ceilingclipsave;
-	portal->floorclip = floorclipsave;
-	portal->frontscale = frontscalesave;
+	R_PortalStoreClipValues(x1, x2, portal->ceilingclip, portal->floorclip, portal->frontscale);
 
 	portal->start = x1;
 	portal->end = x2;
@@ -1199,6 +1553,8 @@ void R_AddPortal(INT32 line1, INT32 line2, INT32 x1, INT32 x2)
 		portal_cap->next = portal;
 		portal_cap = portal;
 	}
+
+	return true;
 }
 
 // ================
@@ -1215,6 +1571,7 @@ void R_RenderPlayerView(player_t *player)
 {
 	portal_pair *portal;
 	const boolean skybox = (skyboxmo[0] && cv_skybox.value);
+	precise_t timer, portaltime;
 
 	if (cv_homremoval.value && player == &players[displayplayer]) // if this is display player 1
 	{
@@ -1224,14 +1581,15 @@ void R_RenderPlayerView(player_t *player)
 			V_DrawFill(0, 0, BASEVIDWIDTH, BASEVIDHEIGHT, 128+(timeinmap&15));
 	}
 
-	// load previous saved value of skyVisible for the player
-	if (splitscreen && player == &players[secondarydisplayplayer])
-		skyVisible = skyVisible2;
-	else
-		skyVisible = skyVisible1;
+	// load previous saved value of skyVisible for this view
+	skyVisible = curview->skyvisible;
 
 	portalrender = 0;
 	portal_base = portal_cap = NULL;
+	numportals = portalpixels = portalsrendered = 0;
+
+	if (cv_texturemips.value)
+		R_CheckMipPalette();
 
 	if (skybox && skyVisible)
 	{
@@ -1245,13 +1603,21 @@ void R_RenderPlayerView(player_t *player)
 		R_ClearVisibleFloorSplats();
 #endif
 
+		timer = R_StartTimer();
+		R_StartWallColumns(cv_renderthreads.value);
 		R_RenderBSPNode((INT32)numnodes - 1);
+		R_LapTimer(timer, RT_BSP);
+		R_FinishWallColumns();
+		R_LapTimer(timer, RT_SEGS);
 		R_ClipSprites();
+		R_LapTimer(timer, RT_SPRITES);
 		R_DrawPlanes();
 #ifdef FLOORSPLATS
 		R_DrawVisibleFloorSplats();
 #endif
+		R_LapTimer(timer, RT_PLANES);
 		R_DrawMasked();
+		R_LapTimer(timer, RT_MASKED);
 	}
 
 	R_SetupFrame(player, skybox);
@@ -1278,8 +1644,12 @@ void R_RenderPlayerView(player_t *player)
 	mytotal = 0;
 	ProfZeroTimer();
 #endif
+	timer = R_StartTimer();
+	R_StartWallColumns(cv_renderthreads.value);
 	R_RenderBSPNode((INT32)numnodes - 1);
+	R_LapTimer(timer, RT_BSP);
 	R_ClipSprites();
+	R_LapTimer(timer, RT_SPRITES);
 #ifdef TIMING
 	RDMSR(0x10, &mycount);
 	mytotal += mycount; // 64bit add
@@ -1303,38 +1673,467 @@ void R_RenderPlayerView(player_t *player)
 
 		validcount++;
 
+		portaltime = rendertime[RT_PORTALS];
 		R_RenderBSPNode((INT32)numnodes - 1);
 		R_ClipSprites();
+		R_LapTimer(timer, RT_PORTALS);
+		portaltime = rendertime[RT_PORTALS] - portaltime;
+		if (portaltime > portaltimemax)
+			portaltimemax = portaltime;
 		//R_DrawPlanes();
 		//R_DrawMasked();
 
-		// okay done. free it.
+		// okay done. it goes back in the pool for the next frame.
 		portalcullsector = NULL; // Just in case...
 		portal_base = portal->next;
-		Z_Free(portal->ceilingclip);
-		Z_Free(portal->floorclip);
-		Z_Free(portal->frontscale);
-		Z_Free(portal);
+		portalsrendered++;
 	}
 	// END PORTAL RENDERING
+	R_LapTimer(timer, RT_BSP);
+
+	R_FinishWallColumns();
+	R_LapTimer(timer, RT_SEGS);
 
 	R_DrawPlanes();
 #ifdef FLOORSPLATS
 	R_DrawVisibleFloorSplats();
 #endif
+	R_LapTimer(timer, RT_PLANES);
 	// draw mid texture and sprite
 	// And now 3D floors/sides!
 	R_DrawMasked();
+	R_LapTimer(timer, RT_MASKED);
+
+	rendercount[RC_PORTALS] += portalsrendered;
 
 	// Check for new console commands.
 	NetUpdate();
 
-	// save value to skyVisible1 or skyVisible2
+	// save value for this view
 	// this is so that P1 can't affect whether P2 can see a skybox or not, or vice versa
-	if (splitscreen && player == &players[secondarydisplayplayer])
-		skyVisible2 = skyVisible;
+	curview->skyvisible = skyVisible;
+}
+
+//
+// R_SetViewContext
+// Switches which part of the screen, and whose saved state, the software
+// renderer is drawing the next view with. View 1 is the second splitscreen
+// player's, at the bottom of the screen.
+//
+void R_SetViewContext(INT32 view)
+{
+	curview = &viewcontexts[view];
+
+	viewwindowy = curview->windowy;
+	M_Memcpy(ylookup, curview->ylookup, viewheight*sizeof (ylookup[0]));
+	topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
+}
+
+// =========================================================================
+//                    RENDER TIMERS & BENCHMARK
+// =========================================================================
+
+//
+// R_StartTimer
+// The time, less everything already counted, so a lap doesn't count it twice.
+//
+precise_t R_StartTimer(void)
+{
+	if (!rendertimers)
+		return 0;
+	return I_GetPreciseTime() - rendertimetotal;
+}
+
+//
+// R_LapTimer
+// Counts the time since the timer started, less whatever laps taken in
+// between counted; that also leaves the timer ready for its next lap.
+//
+void R_LapTimer(precise_t timer, rendertimer_t which)
+{
+	precise_t self;
+
+	if (!rendertimers)
+		return;
+
+	self = I_GetPreciseTime() - rendertimetotal - timer;
+	rendertime[which] += self;
+	rendertimetotal += self;
+}
+
+void R_ResetTimers(void)
+{
+	memset(rendertime, 0, sizeof (rendertime));
+	memset(rendercount, 0, sizeof (rendercount));
+	rendertimetotal = portaltimemax = 0;
+}
+
+//
+// R_LoadBenchViews
+// Reads "x y z angle [aiming]" lines, in map units and degrees.
+//
+static INT32 R_LoadBenchViews(const char *filename, camera_t **views)
+{
+	UINT8 *buf;
+	char *line, *next;
+	INT32 numviews = 0, x, y, z, angle, aiming;
+
+	if (!FIL_ReadFile(filename, &buf))
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Couldn't read %s\n"), filename);
+		return 0;
+	}
+
+	// one view per line at most
+	for (line = (char *)buf, x = 1; *line; line++)
+		if (*line == '\n')
+			x++;
+	*views = Z_Calloc(x * sizeof (**views), PU_STATIC, NULL);
+
+	for (line = (char *)buf; line; line = next)
+	{
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = '\0';
+
+		aiming = 0;
+		if (sscanf(line, "%d %d %d %d %d", &x, &y, &z, &angle, &aiming) < 4)
+			continue; // blank, or a comment
+
+		(*views)[numviews].x = x<<FRACBITS;
+		(*views)[numviews].y = y<<FRACBITS;
+		(*views)[numviews].z = z<<FRACBITS;
+		(*views)[numviews].angle = FixedAngle(angle<<FRACBITS);
+		(*views)[numviews].aiming = FixedAngle(aiming<<FRACBITS);
+		numviews++;
+	}
+
+	Z_Free(buf);
+	return numviews;
+}
+
+//
+// R_SpreadBenchViews
+// Eye height above the level's things, spread over the whole list.
+//
+static INT32 R_SpreadBenchViews(INT32 numviews, camera_t **views)
+{
+	INT32 i;
+
+	if (!nummapthings)
+		return 0;
+
+	*views = Z_Calloc(numviews * sizeof (**views), PU_STATIC, NULL);
+
+	for (i = 0; i < numviews; i++)
+	{
+		const mapthing_t *mt = &mapthings[(size_t)i * nummapthings / numviews];
+		camera_t *view = &(*views)[i];
+		sector_t *sector;
+
+		view->x = mt->x<<FRACBITS;
+		view->y = mt->y<<FRACBITS;
+		view->angle = FixedAngle(mt->angle<<FRACBITS);
+
+		sector = R_PointInSubsector(view->x, view->y)->sector;
+		view->z = sector->floorheight;
+#ifdef ESLOPE
+		if (sector->f_slope)
+			view->z = P_GetZAt(sector->f_slope, view->x, view->y);
+#endif
+		view->z += cv_viewheight.value<<FRACBITS;
+	}
+
+	return numviews;
+}
+
+//
+// R_BenchChecksum
+// FNV-1a of what was just drawn.
+//
+static UINT32 R_BenchChecksum(void)
+{
+	UINT32 hash = 2166136261u;
+	INT32 x, y;
+
+#ifdef HWRENDER
+	if (rendermode == render_opengl)
+	{
+		UINT8 *buf = HWR_GetScreenshot();
+		size_t i, size = (size_t)vid.width * vid.height * 3;
+
+		if (!buf)
+			return 0;
+		for (i = 0; i < size; i++)
+			hash = (hash ^ buf[i]) * 16777619u;
+		free(buf);
+		return hash;
+	}
+#endif
+
+	for (y = 0; y < viewheight; y++)
+	{
+		const UINT8 *row = screens[0] + (viewwindowy + y)*vid.width + viewwindowx;
+		for (x = 0; x < viewwidth; x++)
+			hash = (hash ^ row[x]) * 16777619u;
+	}
+	return hash;
+}
+
+//
+// Command_RenderBench_f
+// renderbench [<views>|<file>] [<frames>]
+// Draws each view of the current level <frames> times over, without
+// showing any of them, and prints a checksum of every frame and where the
+// time went. The views are read from <file>, or spread over the level.
+//
+void Command_RenderBench_f(void)
+{
+	player_t *player = &players[displayplayer];
+	camera_t *views = NULL;
+	INT32 numviews = 16, frames = 4, view, frame, i;
+	precise_t phases[NUMRENDERTIMERS], total = 0, start, portalmax = 0;
+	UINT32 us, portals = 0;
+
+	if (gamestate != GS_LEVEL || rendermode == render_none || !player->mo)
+	{
+		CONS_Printf(M_GetText("You must be in a level to use this.\n"));
+		return;
+	}
+
+	if (COM_Argc() > 2)
+		frames = max(1, atoi(COM_Argv(2)));
+
+	if (COM_Argc() > 1 && !isdigit((UINT8)COM_Argv(1)[0]))
+		numviews = R_LoadBenchViews(COM_Argv(1), &views);
 	else
-		skyVisible1 = skyVisible;
+	{
+		if (COM_Argc() > 1)
+			numviews = max(1, atoi(COM_Argv(1)));
+		numviews = R_SpreadBenchViews(numviews, &views);
+	}
+
+	if (!numviews)
+	{
+		CONS_Printf(M_GetText("No views to draw.\n"));
+		if (views)
+			Z_Free(views);
+		return;
+	}
+
+	CONS_Printf(M_GetText("%s, %dx%d, %d views, %d frames each:\n"),
+		G_BuildMapName(gamemap), vid.width, vid.height, numviews, frames);
+
+	memset(phases, 0, sizeof (phases));
+	for (view = 0; view < numviews; view++)
+	{
+		benchcam = &views[view];
+		benchcam->chase = true;
+		benchcam->subsector = R_PointInSubsector(benchcam->x, benchcam->y);
+
+		for (frame = 0; frame < frames; frame++)
+		{
+			R_ResetTimers();
+			rendertimers = true;
+			start = I_GetPreciseTime();
+
+#ifdef HWRENDER
+			if (rendermode != render_soft)
+				HWR_RenderPlayerView(0, player);
+			else
+#endif
+			{
+				topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
+				R_RenderPlayerView(player);
+			}
+
+			start = I_GetPreciseTime() - start;
+			rendertimers = false;
+			total += start;
+			for (i = 0; i < NUMRENDERTIMERS; i++)
+				phases[i] += rendertime[i];
+			portals += portalsrendered;
+			if (portaltimemax > portalmax)
+				portalmax = portaltimemax;
+
+			CONS_Printf("view %3d frame %2d: %08x %6d us\n", view, frame,
+				R_BenchChecksum(), I_PreciseToMicros(start));
+		}
+	}
+	benchcam = NULL;
+	Z_Free(views);
+
+	frames *= numviews;
+	us = (UINT32)I_PreciseToMicros(total) / frames;
+	CONS_Printf(M_GetText("%d frames, %u.%03u ms/frame"), frames, us / 1000, us % 1000);
+	if (rendermode == render_soft)
+	{
+		for (i = 0; i < NUMRENDERTIMERS; i++)
+		{
+			us = (UINT32)I_PreciseToMicros(phases[i]) / frames;
+			CONS_Printf(", %s %u.%03u", rendertimernames[i], us / 1000, us % 1000);
+		}
+		if (portals)
+		{
+			CONS_Printf(M_GetText(", %u.%02u portals/frame"), portals / frames, portals * 100 / frames % 100);
+			us = (UINT32)I_PreciseToMicros(phases[RT_PORTALS]) / portals;
+			CONS_Printf(M_GetText(", %u.%03u ms/portal"), us / 1000, us % 1000);
+			us = (UINT32)I_PreciseToMicros(portalmax);
+			CONS_Printf(M_GetText(", slowest portal %u.%03u"), us / 1000, us % 1000);
+		}
+	}
+	CONS_Printf("\n");
+}
+
+// =========================================================================
+//                              RENDER STATS
+// =========================================================================
+
+// With cv_renderstats on, D_Display times every frame it draws, and the
+// last RENDERSTATFRAMES of them are kept to find percentiles from.
+
+#define RENDERSTATFRAMES 256
+#define NUMRENDERSTATS (1 + NUMRENDERTIMERS + NUMRENDERCOUNTERS + 2)
+
+// The whole frame, then each timer in microseconds, then each counter,
+// then the average and slowest portal pass in microseconds
+static UINT32 renderstats[RENDERSTATFRAMES][NUMRENDERSTATS];
+static size_t numrenderstats = 0, nextrenderstat = 0;
+
+static int R_CompareRenderStats(const void *a, const void *b)
+{
+	UINT32 sa = *(const UINT32 *)a, sb = *(const UINT32 *)b;
+	return (sa > sb) - (sa < sb);
+}
+
+//
+// R_RecordRenderStats
+// Keeps what the timers and counters added up to for a frame that took
+// frametime to draw.
+//
+void R_RecordRenderStats(precise_t frametime)
+{
+	UINT32 *stat = renderstats[nextrenderstat];
+	INT32 i;
+
+	*stat++ = (UINT32)I_PreciseToMicros(frametime);
+	for (i = 0; i < NUMRENDERTIMERS; i++)
+		*stat++ = (UINT32)I_PreciseToMicros(rendertime[i]);
+	for (i = 0; i < NUMRENDERCOUNTERS; i++)
+		*stat++ = rendercount[i];
+	*stat++ = rendercount[RC_PORTALS] ? (UINT32)I_PreciseToMicros(rendertime[RT_PORTALS]) / rendercount[RC_PORTALS] : 0;
+	*stat++ = (UINT32)I_PreciseToMicros(portaltimemax);
+
+	nextrenderstat = (nextrenderstat + 1) % RENDERSTATFRAMES;
+	if (numrenderstats < RENDERSTATFRAMES)
+		numrenderstats++;
+}
+
+//
+// R_RenderStatPercentiles
+// Fills in the 50th, 95th and 99th percentiles and the worst of a stat,
+// over the frames kept.
+//
+static void R_RenderStatPercentiles(INT32 which, UINT32 *percentiles)
+{
+	UINT32 sorted[RENDERSTATFRAMES];
+	size_t i;
+
+	for (i = 0; i < numrenderstats; i++)
+		sorted[i] = renderstats[i][which];
+	qsort(sorted, numrenderstats, sizeof (*sorted), R_CompareRenderStats);
+
+	percentiles[0] = sorted[numrenderstats/2];
+	percentiles[1] = sorted[numrenderstats*95/100];
+	percentiles[2] = sorted[numrenderstats*99/100];
+	percentiles[3] = sorted[numrenderstats-1];
+}
+
+static const char *R_RenderStatName(INT32 which)
+{
+	if (!which)
+		return "frame";
+	if (which <= NUMRENDERTIMERS)
+		return rendertimernames[which-1];
+	if (which <= NUMRENDERTIMERS + NUMRENDERCOUNTERS)
+		return rendercounternames[which-1-NUMRENDERTIMERS];
+	return (which == NUMRENDERSTATS-2) ? "portal avg" : "portal max";
+}
+
+// Times in milliseconds, counts as they are
+static const char *R_RenderStatValue(INT32 which, UINT32 value)
+{
+	if (which <= NUMRENDERTIMERS || which > NUMRENDERTIMERS + NUMRENDERCOUNTERS)
+		return va("%u.%02u", value / 1000, value / 10 % 100);
+	return va("%u", value);
+}
+
+//
+// R_DrawRenderStats
+// The renderstats overlay: this frame, and the percentiles of the last few
+// hundred, for everything R_RecordRenderStats keeps.
+//
+void R_DrawRenderStats(void)
+{
+	const INT32 flags = V_SNAPTOLEFT|V_SNAPTOTOP|V_ALLOWLOWERCASE;
+	const INT32 columns[6] = {4, 58, 92, 126, 160, 194};
+	UINT32 percentiles[4];
+	INT32 i, y = 4;
+
+	if (!numrenderstats)
+		return;
+
+	V_DrawThinString(columns[0], y, flags|V_YELLOWMAP, "render");
+	V_DrawThinString(columns[1], y, flags|V_YELLOWMAP, "now");
+	V_DrawThinString(columns[2], y, flags|V_YELLOWMAP, "50%");
+	V_DrawThinString(columns[3], y, flags|V_YELLOWMAP, "95%");
+	V_DrawThinString(columns[4], y, flags|V_YELLOWMAP, "99%");
+	V_DrawThinString(columns[5], y, flags|V_YELLOWMAP, "worst");
+
+	for (i = 0; i < NUMRENDERSTATS; i++)
+	{
+		y += 8;
+		R_RenderStatPercentiles(i, percentiles);
+		V_DrawThinString(columns[0], y, flags, R_RenderStatName(i));
+		V_DrawThinString(columns[1], y, flags,
+			R_RenderStatValue(i, renderstats[(nextrenderstat + RENDERSTATFRAMES - 1) % RENDERSTATFRAMES][i]));
+		V_DrawThinString(columns[2], y, flags, R_RenderStatValue(i, percentiles[0]));
+		V_DrawThinString(columns[3], y, flags, R_RenderStatValue(i, percentiles[1]));
+		V_DrawThinString(columns[4], y, flags, R_RenderStatValue(i, percentiles[2]));
+		V_DrawThinString(columns[5], y, flags, R_RenderStatValue(i, percentiles[3]));
+	}
+}
+
+//
+// Command_RenderStatsLog_f
+// Prints the percentiles the overlay shows, so they end up in the log.
+//
+static void Command_RenderStatsLog_f(void)
+{
+	UINT32 percentiles[4];
+	INT32 i;
+
+	if (!numrenderstats)
+	{
+		CONS_Printf(M_GetText("No frames recorded; turn on renderstats first.\n"));
+		return;
+	}
+
+	CONS_Printf(M_GetText("Last %s frames at %dx%d (ms, or counts):\n"), sizeu1(numrenderstats), vid.width, vid.height);
+	for (i = 0; i < NUMRENDERSTATS; i++)
+	{
+		R_RenderStatPercentiles(i, percentiles);
+		CONS_Printf("%-12s 50%% %s", R_RenderStatName(i), R_RenderStatValue(i, percentiles[0]));
+		CONS_Printf(", 95%% %s", R_RenderStatValue(i, percentiles[1]));
+		CONS_Printf(", 99%% %s", R_RenderStatValue(i, percentiles[2]));
+		CONS_Printf(", worst %s\n", R_RenderStatValue(i, percentiles[3]));
+	}
+}
+
+static void RenderStats_OnChange(void)
+{
+	// Start over, rather than mix in frames from whenever it was last on
+	numrenderstats = nextrenderstat = 0;
 }
 
 // =========================================================================
@@ -1351,10 +2150,23 @@ void R_RegisterEngineStuff(void)
 	CV_RegisterVar(&cv_flipcam);
 	CV_RegisterVar(&cv_flipcam2);
 
+	COM_AddCommand("subsectorstats", Command_SubsectorStats_f);
+#ifdef ESLOPE
+	COM_AddCommand("slopestats", Command_SlopeStats_f);
+#endif
+
 	// Enough for dedicated server
 	if (dedicated)
 		return;
 
+	COM_AddCommand("visplanestats", Command_VisplaneStats_f);
+	COM_AddCommand("drawerbench", Command_DrawerBench_f);
+	COM_AddCommand("hudbench", Command_HudBench_f);
+	COM_AddCommand("translationstats", Command_TranslationStats_f);
+	COM_AddCommand("renderbench", Command_RenderBench_f);
+	COM_AddCommand("framestats", Command_FrameStats_f);
+	COM_AddCommand("renderstatslog", Command_RenderStatsLog_f);
+
 	CV_RegisterVar(&cv_precipdensity);
 	CV_RegisterVar(&cv_translucency);
 	CV_RegisterVar(&cv_drawdist);
@@ -1366,6 +2178,14 @@ void R_RegisterEngineStuff(void)
 	CV_RegisterVar(&cv_shadow);
 	CV_RegisterVar(&cv_shadowoffs);
 	CV_RegisterVar(&cv_skybox);
+	CV_RegisterVar(&cv_renderthreads);
+#ifdef ESLOPE
+	CV_RegisterVar(&cv_slopespansize);
+#endif
+	CV_RegisterVar(&cv_frameinterpolation);
+	CV_RegisterVar(&cv_fpscap);
+	CV_RegisterVar(&cv_texturemips);
+	CV_RegisterVar(&cv_renderstats);
 
 	CV_RegisterVar(&cv_cam_dist);
 	CV_RegisterVar(&cv_cam_still);
@@ -1385,6 +2205,7 @@ void R_RegisterEngineStuff(void)
 	CV_RegisterVar(&cv_translucenthud);
 
 	CV_RegisterVar(&cv_maxportals);
+	CV_RegisterVar(&cv_portalbudget);
 
 	// Default viewheight is changeable,
 	// initialized to standard viewheight
@@ -65,6 +65,8 @@ fixed_t R_PointToDist2(fixed_t px2, fixed_t py2, fixed_t px1, fixed_t py1);
 fixed_t R_ScaleFromGlobalAngle(angle_t visangle);
 subsector_t *R_PointInSubsector(fixed_t x, fixed_t y);
 subsector_t *R_IsPointInSubsector(fixed_t x, fixed_t y);
+subsector_t *R_PointInSubsectorHint(fixed_t x, fixed_t y, subsector_t *hint);
+void R_BuildSubsectorHints(void);
 
 boolean R_DoCulling(line_t *cullheight, line_t *viewcullheight, fixed_t vz, fixed_t bottomh, fixed_t toph);
 
@@ -80,6 +82,12 @@ extern consvar_t cv_shadow, cv_shadowoffs;
 extern consvar_t cv_translucency;
 extern consvar_t cv_precipdensity, cv_drawdist, cv_drawdist_nights, cv_drawdist_precip;
 extern consvar_t cv_skybox;
+extern consvar_t cv_renderthreads;
+extern consvar_t cv_texturemips;
+extern consvar_t cv_renderstats;
+#ifdef ESLOPE
+extern consvar_t cv_slopespansize;
+#endif
 extern consvar_t cv_tailspickup;
 
 // Called by startup code.
@@ -98,6 +106,68 @@ void R_SetupFrame(player_t *player, boolean skybox);
 // Called by G_Drawer.
 void R_RenderPlayerView(player_t *player);
 
+// What differs between the views drawn each frame in splitscreen.
+// Everything else the renderer uses is shared, so they are drawn one by one.
+typedef struct
+{
+	INT32 windowy; // viewwindowy for this view
+	UINT8 **ylookup; // its row offsets, copied into ylookup
+	boolean skyvisible; // whether the last frame saw sky, so the skybox is worth drawing
+} viewcontext_t;
+
+extern viewcontext_t viewcontexts[2];
+extern viewcontext_t *curview;
+
+void R_SetViewContext(INT32 view);
+
+// Where the time in R_RenderPlayerView goes, added up while rendertimers is set
+typedef enum
+{
+	RT_BSP, // walking the tree, without the segs and sprites found on the way
+	RT_PORTALS, // walking it again for each portal's view
+	RT_SEGS,
+	RT_PLANES,
+	RT_SPRITES,
+	RT_DRAWNODES, // sorting the sprites in among the masked surfaces
+	RT_MASKED, // and then drawing them all
+	RT_POSTPROCESS, // V_DoPostProcessor, after the views are drawn
+	NUMRENDERTIMERS
+} rendertimer_t;
+
+extern boolean rendertimers;
+extern precise_t rendertime[NUMRENDERTIMERS];
+extern const char *const rendertimernames[NUMRENDERTIMERS];
+extern precise_t portaltimemax; // the slowest single portal's part of RT_PORTALS
+
+// What got drawn, counted whether or not rendertimers is set, and reset with them
+typedef enum
+{
+	RC_VISPLANES,
+	RC_DRAWSEGS,
+	RC_VISSPRITES,
+	RC_DRAWNODES,
+	RC_PORTALS,
+	RC_SPANS,
+	RC_COLUMNS,
+	NUMRENDERCOUNTERS
+} rendercounter_t;
+
+extern UINT32 rendercount[NUMRENDERCOUNTERS];
+extern const char *const rendercounternames[NUMRENDERCOUNTERS];
+
+// Timers nest: a lap only counts time not already counted by laps
+// taken inside it, and the timer carries on from there.
+precise_t R_StartTimer(void);
+void R_LapTimer(precise_t timer, rendertimer_t which);
+void R_ResetTimers(void);
+
+// Draws a list of fixed views of the current level and times them
+void Command_RenderBench_f(void);
+
+// The renderstats overlay, from the timers and counters of each frame
+void R_RecordRenderStats(precise_t frametime);
+void R_DrawRenderStats(void);
+
 // add commands related to engine, at game startup
 void R_RegisterEngineStuff(void);
 #endif
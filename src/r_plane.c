@@ -46,22 +46,90 @@
 #define SHITPLANESPARENCY
 
 //SoM: 3/23/2000: Use Boom visplane hashing.
-#define MAXVISPLANES 512
+// The bucket table starts at this size and doubles (at the start of a
+// frame) whenever the previous frame produced more planes than buckets.
+#define MINVISPLANEBUCKETS 512
 
-static visplane_t *visplanes[MAXVISPLANES];
-static visplane_t *freetail;
-static visplane_t **freehead = &freetail;
+static visplane_t **visplanes = NULL;
+static UINT32 numvisplanebuckets = 0;
+
+// Visplanes are handed out from a pool of chunks that is rewound every
+// frame, so plane storage is never freed or relinked while rendering.
+#define VISPLANECHUNKBITS 5 // 32 planes per chunk
+#define VISPLANESPERCHUNK (1 << VISPLANECHUNKBITS)
+#define VISPLANEINDEXMASK (VISPLANESPERCHUNK - 1)
+
+static visplane_t **visplanechunks = NULL;
+static UINT32 numvisplanechunks = 0;
+static UINT32 numvisplanes = 0; // planes used since the last R_ClearPlanes
 
 visplane_t *floorplane;
 visplane_t *ceilingplane;
 static visplane_t *currentplane;
 
+// The flat of the plane being drawn, and its mips after it
+static UINT8 *planemips[MAXMIPLEVELS+1];
+static INT32 planemiplevels, planemiplevel;
+static INT32 planeflatbits; // log2 of the flat's size
+
 visffloor_t ffloor[MAXFFLOORS];
 INT32 numffloors;
 
-//SoM: 3/23/2000: Boom visplane hashing routine.
-#define visplane_hash(picnum,lightlevel,height) \
-  ((unsigned)((picnum)*3+(lightlevel)+(height)*7) & (MAXVISPLANES-1))
+#ifdef POLYOBJECTS_PLANES
+#define PLANEPOLYOBJ(p) (p)
+#else
+#define PLANEPOLYOBJ(p) NULL
+#endif
+#ifdef ESLOPE
+#define PLANESLOPE(s) (s)
+#else
+#define PLANESLOPE(s) NULL
+#endif
+
+//
+// visplane_hash
+// Mixes every key R_FindPlane compares (murmur3 style) so that planes
+// differing only in offsets, slope or FOF don't pile into one bucket.
+//
+static inline UINT32 visplane_mix(UINT32 h, UINT32 k)
+{
+	k *= 0xcc9e2d51;
+	k = (k << 15) | (k >> 17);
+	k *= 0x1b873593;
+	h ^= k;
+	h = (h << 13) | (h >> 19);
+	return h*5 + 0xe6546b64;
+}
+
+static inline UINT32 visplane_ptrkey(const void *p)
+{
+	UINT64 v = (UINT64)(size_t)p;
+	return (UINT32)(v ^ (v >> 32));
+}
+
+static UINT32 visplane_hash(fixed_t height, INT32 picnum, INT32 lightlevel,
+	fixed_t xoff, fixed_t yoff, const void *pfloor, const void *polyobj, const void *slope)
+{
+	UINT32 h = 0;
+
+	h = visplane_mix(h, (UINT32)height);
+	h = visplane_mix(h, (UINT32)picnum);
+	h = visplane_mix(h, (UINT32)lightlevel);
+	h = visplane_mix(h, (UINT32)xoff);
+	h = visplane_mix(h, (UINT32)yoff);
+	h = visplane_mix(h, visplane_ptrkey(pfloor));
+	h = visplane_mix(h, visplane_ptrkey(polyobj));
+	h = visplane_mix(h, visplane_ptrkey(slope));
+
+	// fmix32 finalizer
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+
+	return h & (numvisplanebuckets - 1);
+}
 
 //SoM: 3/23/2000: Use boom opening limit removal
 size_t maxopenings;
@@ -258,6 +326,18 @@ static void R_DrawTranslucentWaterSpan_8(void)
 }
 #endif
 
+//
+// R_SetFlatShifts
+// Sets the span drawers up for a flat with 1<<bits texels a side.
+//
+static void R_SetFlatShifts(INT32 bits)
+{
+	nflatmask = ((1 << bits) - 1) << bits;
+	nflatxshift = 32 - bits;
+	nflatyshift = 32 - 2*bits;
+	nflatshiftup = 16 - bits;
+}
+
 void R_MapPlane(INT32 y, INT32 x1, INT32 x2)
 {
 	angle_t angle, planecos, planesin;
@@ -318,6 +398,24 @@ void R_MapPlane(INT32 y, INT32 x1, INT32 x2)
 	}
 #endif
 
+	// Far away spans are drawn from a smaller copy of the flat
+	if (planemiplevels)
+	{
+		const INT32 level = R_MipLevel(max(abs(ds_xstep), abs(ds_ystep)), planemiplevels);
+
+		if (level != planemiplevel)
+		{
+			planemiplevel = level;
+			ds_source = planemips[level];
+			R_SetFlatShifts(planeflatbits - level);
+		}
+
+		ds_xfrac >>= level;
+		ds_yfrac >>= level;
+		ds_xstep >>= level;
+		ds_ystep >>= level;
+	}
+
 	pindex = distance >> LIGHTZSHIFT;
 	if (pindex >= MAXLIGHTZ)
 		pindex = MAXLIGHTZ - 1;
@@ -335,6 +433,7 @@ void R_MapPlane(INT32 y, INT32 x1, INT32 x2)
 	ds_y = y;
 	ds_x1 = x1;
 	ds_x2 = x2;
+	rendercount[RC_SPANS]++;
 
 	// profile drawer
 #ifdef TIMING
@@ -375,12 +474,21 @@ void R_ClearPlanes(void)
 
 	numffloors = 0;
 
-	for (i = 0; i < MAXVISPLANES; i++)
-	for (*freehead = visplanes[i], visplanes[i] = NULL;
-		freehead && *freehead ;)
+	// Grow the bucket table if last frame overloaded it; it is emptied
+	// here anyway, so nothing needs rehashing.
+	if (!numvisplanebuckets || numvisplanes > numvisplanebuckets)
 	{
-		freehead = &(*freehead)->next;
+		UINT32 newsize = numvisplanebuckets ? numvisplanebuckets : MINVISPLANEBUCKETS;
+		while (newsize < numvisplanes)
+			newsize <<= 1;
+		if (newsize != numvisplanebuckets)
+		{
+			visplanes = Z_Realloc(visplanes, newsize * sizeof (*visplanes), PU_STATIC, NULL);
+			numvisplanebuckets = newsize;
+		}
 	}
+	memset(visplanes, 0, numvisplanebuckets * sizeof (*visplanes));
+	numvisplanes = 0;
 
 	lastopening = openings;
 
@@ -395,25 +503,61 @@ void R_ClearPlanes(void)
 	baseyscale = -FixedDiv (FINESINE(angle),centerxfrac);
 }
 
-static visplane_t *new_visplane(unsigned hash)
+static visplane_t *new_visplane(UINT32 hash)
 {
-	visplane_t *check = freetail;
-	if (!check)
-	{
-		check = calloc(2, sizeof (*check));
-		if (check == NULL) I_Error("%s: Out of memory", "new_visplane"); // FIXME: ugly
-	}
-	else
+	visplane_t *check;
+	UINT32 chunk = numvisplanes >> VISPLANECHUNKBITS;
+
+	// Allocate chunk if necessary
+	if (chunk >= numvisplanechunks)
 	{
-		freetail = freetail->next;
-		if (!freetail)
-			freehead = &freetail;
+		UINT32 newchunks = numvisplanechunks ? numvisplanechunks*2 : 8;
+		visplanechunks = Z_Realloc(visplanechunks, newchunks * sizeof (*visplanechunks), PU_STATIC, NULL);
+		memset(visplanechunks + numvisplanechunks, 0, (newchunks - numvisplanechunks) * sizeof (*visplanechunks));
+		numvisplanechunks = newchunks;
 	}
+	if (!visplanechunks[chunk])
+		Z_Malloc(sizeof (visplane_t) * VISPLANESPERCHUNK, PU_STATIC, &visplanechunks[chunk]);
+
+	check = visplanechunks[chunk] + (numvisplanes & VISPLANEINDEXMASK);
+	numvisplanes++;
+
 	check->next = visplanes[hash];
 	visplanes[hash] = check;
 	return check;
 }
 
+//
+// Command_VisplaneStats_f
+// Prints how the planes of the last rendered view are spread over the hash.
+//
+void Command_VisplaneStats_f(void)
+{
+	UINT32 i, used = 0, longest = 0, pooled = 0;
+	visplane_t *pl;
+
+	for (i = 0; i < numvisplanechunks; i++)
+		if (visplanechunks[i])
+			pooled += VISPLANESPERCHUNK;
+
+	for (i = 0; i < numvisplanebuckets; i++)
+	{
+		UINT32 len = 0;
+		for (pl = visplanes[i]; pl; pl = pl->next)
+			len++;
+		if (len)
+			used++;
+		if (len > longest)
+			longest = len;
+	}
+
+	CONS_Printf(M_GetText("Visplanes: %u in %u buckets (%u used), pool holds %u\n"),
+		numvisplanes, numvisplanebuckets, used, pooled);
+	if (used)
+		CONS_Printf(M_GetText("Chain length: longest %u, average %u.%02u\n"),
+			longest, numvisplanes / used, (numvisplanes % used) * 100 / used);
+}
+
 //
 // R_FindPlane: Seek a visplane having the identical values:
 //              Same height, same flattexture, same lightlevel.
@@ -431,7 +575,7 @@ visplane_t *R_FindPlane(fixed_t height, INT32 picnum, INT32 lightlevel,
 			)
 {
 	visplane_t *check;
-	unsigned hash;
+	UINT32 hash;
 
 #ifdef ESLOPE
 	if (slope); else // Don't mess with this right now if a slope is involved
@@ -457,7 +601,8 @@ visplane_t *R_FindPlane(fixed_t height, INT32 picnum, INT32 lightlevel,
 	}
 
 	// New visplane algorithm uses hash table
-	hash = visplane_hash(picnum, lightlevel, height);
+	hash = visplane_hash(height, picnum, lightlevel, xoff, yoff, pfloor,
+		PLANEPOLYOBJ(polyobj), PLANESLOPE(slope));
 
 	for (check = visplanes[hash]; check; check = check->next)
 	{
@@ -555,8 +700,9 @@ visplane_t *R_CheckPlane(visplane_t *pl, INT32 start, INT32 stop)
 	}
 	else /* Cannot use existing plane; create a new one */
 	{
-		unsigned hash =
-			visplane_hash(pl->picnum, pl->lightlevel, pl->height);
+		UINT32 hash = visplane_hash(pl->height, pl->picnum, pl->lightlevel,
+			pl->xoffs, pl->yoffs, pl->ffloor,
+			PLANEPOLYOBJ(pl->polyobj), PLANESLOPE(pl->slope));
 		visplane_t *new_pl = new_visplane(hash);
 
 		new_pl->height = pl->height;
@@ -668,12 +814,13 @@ void R_DrawPlanes(void)
 	visplane_t *pl;
 	INT32 x;
 	INT32 angle;
-	INT32 i;
+	UINT32 i;
 
 	spanfunc = basespanfunc;
 	wallcolfunc = walldrawerfunc;
+	rendercount[RC_VISPLANES] += numvisplanes;
 
-	for (i = 0; i < MAXVISPLANES; i++, pl++)
+	for (i = 0; i < numvisplanebuckets; i++)
 	{
 		for (pl = visplanes[i]; pl; pl = pl->next)
 		{
@@ -710,6 +857,7 @@ void R_DrawPlanes(void)
 							R_GetColumn(skytexture,
 								angle);
 						wallcolfunc();
+						rendercount[RC_COLUMNS]++;
 					}
 				}
 				continue;
@@ -749,7 +897,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 
 #ifdef POLYOBJECTS_PLANES
 	if (pl->polyobj && pl->polyobj->translucency != 0) {
-		spanfunc = R_DrawTranslucentSpan_8;
+		spanfunc = transspanfunc;
 
 		// Hacked up support for alpha value in software mode Tails 09-24-2002 (sidenote: ported to polys 10-15-2014, there was no time travel involved -Red)
 		if (pl->polyobj->translucency >= 10)
@@ -791,7 +939,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 
 		if (pl->ffloor->flags & FF_TRANSLUCENT)
 		{
-			spanfunc = R_DrawTranslucentSpan_8;
+			spanfunc = transspanfunc;
 
 			// Hacked up support for alpha value in software mode Tails 09-24-2002
 			if (pl->ffloor->alpha < 12)
@@ -828,7 +976,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 		}
 		else if (pl->ffloor->flags & FF_FOG)
 		{
-			spanfunc = R_DrawFogSpan_8;
+			spanfunc = fogspanfunc;
 			light = (pl->lightlevel >> LIGHTSEGSHIFT);
 		}
 		else light = (pl->lightlevel >> LIGHTSEGSHIFT);
@@ -843,7 +991,7 @@ void R_DrawSinglePlane(visplane_t *pl)
 			INT32 top, bottom;
 
 			itswater = true;
-			if (spanfunc == R_DrawTranslucentSpan_8)
+			if (spanfunc == transspanfunc)
 			{
 				spanfunc = R_DrawTranslucentWaterSpan_8;
 
@@ -932,6 +1080,19 @@ void R_DrawSinglePlane(visplane_t *pl)
 			break;
 	}
 
+	planemips[0] = ds_source;
+	planemiplevels = planemiplevel = 0;
+	planeflatbits = 32 - nflatxshift;
+
+	// Transparent pixels can't be averaged, and fog doesn't read the flat at all
+	if (cv_texturemips.value && spanfunc != splatfunc && spanfunc != fogspanfunc
+		&& size == (size_t)1 << (2*planeflatbits)
+#ifdef ESLOPE
+		&& !pl->slope
+#endif
+		)
+		planemiplevels = R_GetFlatMips(levelflats[pl->picnum].lumpnum, 1 << planeflatbits, planemips);
+
 	xoffs = pl->xoffs;
 	yoffs = pl->yoffs;
 	planeheight = abs(pl->height - pl->viewz);
@@ -1031,7 +1192,9 @@ void R_DrawSinglePlane(visplane_t *pl)
 		ds_sv.z *= SFMULT;
 #undef SFMULT
 
-		if (spanfunc == R_DrawTranslucentSpan_8)
+		ds_tiltspansize = cv_slopespansize.value;
+
+		if (spanfunc == transspanfunc)
 			spanfunc = R_DrawTiltedTranslucentSpan_8;
 		else if (spanfunc == splatfunc)
 			spanfunc = R_DrawTiltedSplat_8;
@@ -1083,11 +1246,11 @@ a 'smoothing' of the texture while
 using the palette colors.
 */
 #ifdef QUINCUNX
-	if (spanfunc == R_DrawSpan_8)
+	if (spanfunc == basespanfunc)
 	{
 		INT32 i;
 		ds_transmap = transtables + ((tr_trans50-1)<<FF_TRANSSHIFT);
-		spanfunc = R_DrawTranslucentSpan_8;
+		spanfunc = transspanfunc;
 		for (i=0; i<4; i++)
 		{
 			xoffs = pl->xoffs;
@@ -1137,6 +1300,13 @@ using the palette colors.
 	}
 #endif
 
+	if (planemiplevel)
+	{
+		ds_source = planemips[0];
+		R_SetFlatShifts(planeflatbits);
+	}
+	planemiplevels = 0;
+
 	Z_ChangeTag(ds_source, PU_CACHE);
 }
 
@@ -95,6 +95,8 @@ void R_PlaneBounds(visplane_t *plane);
 // Draws a single visplane.
 void R_DrawSinglePlane(visplane_t *pl);
 
+void Command_VisplaneStats_f(void);
+
 typedef struct planemgr_s
 {
 	visplane_t *plane;
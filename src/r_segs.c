@@ -106,6 +106,7 @@ static void R_DrawSplatColumn(column_t *column)
 
 			// Drawn by R_DrawColumn.
 			colfunc();
+			rendercount[RC_COLUMNS]++;
 		}
 		column = (column_t *)((UINT8 *)column + column->length + 4);
 	}
@@ -268,6 +269,7 @@ static void R_Render2sidedMultiPatchColumn(column_t *column)
 	if (dc_yl <= dc_yh && dc_yh < vid.height && dc_yh > 0)
 	{
 		dc_source = (UINT8 *)column + 3;
+		rendercount[RC_COLUMNS]++;
 
 		if (colfunc == wallcolfunc)
 			twosmultipatchfunc();
@@ -1295,6 +1297,30 @@ UINT32 nombre = 100000;
 //profile stuff ---------------------------------------------------------
 
 
+static fixed_t walliscale; // dc_iscale of the current column at full size
+static INT32 wallmiplevel;
+
+//
+// R_SetWallColumn
+// Points the column drawer at a column of one of the wall tiers,
+// from the mip level set for this column if the texture has it.
+//
+
+static void R_SetWallColumn(INT32 texnum, INT32 texturecolumn, fixed_t texturemid)
+{
+	INT32 level = wallmiplevel;
+
+	if (level)
+		dc_source = R_GetMipColumn(texnum, texturecolumn, &level);
+	else
+		dc_source = R_GetColumn(texnum, texturecolumn);
+
+	dc_texturemid = texturemid >> level;
+	dc_iscale = walliscale >> level;
+	dc_texheight = (textureheight[texnum]>>FRACBITS) >> level;
+	rendercount[RC_COLUMNS]++;
+}
+
 static void R_RenderSegLoop (void)
 {
 	angle_t angle;
@@ -1457,6 +1483,9 @@ static void R_RenderSegLoop (void)
 			dc_x = rw_x;
 			dc_iscale = 0xffffffffu / (unsigned)rw_scale;
 
+			walliscale = dc_iscale;
+			wallmiplevel = cv_texturemips.value ? R_MipLevel(walliscale, MAXMIPLEVELS) : 0;
+
 			if (frontsector->extra_colormap)
 				dc_colormap = frontsector->extra_colormap->colormap + (dc_colormap - colormaps);
 		}
@@ -1507,9 +1536,7 @@ static void R_RenderSegLoop (void)
 			{
 				dc_yl = yl;
 				dc_yh = yh;
-				dc_texturemid = rw_midtexturemid;
-				dc_source = R_GetColumn(midtexture,texturecolumn);
-				dc_texheight = textureheight[midtexture]>>FRACBITS;
+				R_SetWallColumn(midtexture, texturecolumn, rw_midtexturemid);
 
 				//profile stuff ---------------------------------------------------------
 #ifdef TIMING
@@ -1560,9 +1587,7 @@ static void R_RenderSegLoop (void)
 					{
 						dc_yl = yl;
 						dc_yh = mid;
-						dc_texturemid = rw_toptexturemid;
-						dc_source = R_GetColumn(toptexture,texturecolumn);
-						dc_texheight = textureheight[toptexture]>>FRACBITS;
+						R_SetWallColumn(toptexture, texturecolumn, rw_toptexturemid);
 						colfunc();
 						ceilingclip[rw_x] = (INT16)mid;
 					}
@@ -1593,10 +1618,7 @@ static void R_RenderSegLoop (void)
 					{
 						dc_yl = mid;
 						dc_yh = yh;
-						dc_texturemid = rw_bottomtexturemid;
-						dc_source = R_GetColumn(bottomtexture,
-							texturecolumn);
-						dc_texheight = textureheight[bottomtexture]>>FRACBITS;
+						R_SetWallColumn(bottomtexture, texturecolumn, rw_bottomtexturemid);
 						colfunc();
 						floorclip[rw_x] = (INT16)mid;
 					}
@@ -3117,6 +3139,7 @@ void R_StoreWallRange(INT32 start, INT32 stop)
 		M_Memcpy(last_floorclip + ds_p->x1, floorclip + ds_p->x1,
 			sizeof (INT16) * (ds_p->x2 - ds_p->x1 + 1));
 		R_RenderSegLoop();
+		R_FlushWallColumns(); // splats go on top of the wall
 		R_DrawWallSplats();
 	}
 	else
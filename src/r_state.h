@@ -85,16 +85,16 @@ extern side_t *sides;
 extern fixed_t viewx, viewy, viewz;
 extern angle_t viewangle, aimingangle;
 extern boolean viewsky, skyVisible;
-extern boolean skyVisible1, skyVisible2; // saved values of skyVisible for P1 and P2, for splitscreen
 extern sector_t *viewsector;
 extern player_t *viewplayer;
 extern UINT8 portalrender;
 extern sector_t *portalcullsector;
 extern line_t *portalclipline;
 extern INT32 portalclipstart, portalclipend;
+extern INT32 portalsrendered; // this frame
 
 extern consvar_t cv_allowmlook;
-extern consvar_t cv_maxportals;
+extern consvar_t cv_maxportals, cv_portalbudget;
 
 extern angle_t clipangle;
 extern angle_t doubleclipangle;
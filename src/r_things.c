@@ -643,6 +643,7 @@ void R_DrawMaskedColumn(column_t *column)
 			// This stuff is a likely cause of the splitscreen water crash bug.
 			// FIXTHIS: Figure out what "something more proper" is and do it.
 			// quick fix... something more proper should be done!!!
+			rendercount[RC_COLUMNS]++;
 			if (ylookup[dc_yl])
 				colfunc();
 			else if (colfunc == R_DrawColumn_8
@@ -714,6 +715,7 @@ static void R_DrawFlippedMaskedColumn(column_t *column, INT32 texheight)
 			dc_texturemid = basetexturemid - (topdelta<<FRACBITS);
 
 			// Still drawn by R_DrawColumn.
+			rendercount[RC_COLUMNS]++;
 			if (ylookup[dc_yl])
 				colfunc();
 			else if (colfunc == R_DrawColumn_8
@@ -1631,89 +1633,390 @@ void R_AddSprites(sector_t *sec, INT32 lightlevel)
 //
 static vissprite_t vsprsortedhead;
 
+// Scratch space for R_SortVisSprites
+static vissprite_t *vsprsortbuf[MAXVISSPRITES], *vsprsorttemp[MAXVISSPRITES];
+
+// Draw order: smallest scale first, and for the same scale, smallest dispoffset first
+#define VSPRBEFORE(a, b) ((a)->scale < (b)->scale || ((a)->scale == (b)->scale && (a)->dispoffset < (b)->dispoffset))
+
 void R_SortVisSprites(void)
 {
-	UINT32       i;
-	vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
-	vissprite_t *best = NULL;
-	vissprite_t  unsorted;
-	fixed_t      bestscale;
-	INT32        bestdispoffset;
+	UINT32 i, width, lo, mid, hi, l, r, k;
+	vissprite_t **src = vsprsortbuf, **dst = vsprsorttemp, **swap;
+
+	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
 
 	if (!visspritecount)
 		return;
 
-	unsorted.next = unsorted.prev = &unsorted;
-
-	dsfirst = R_GetVisSprite(0);
+	for (i = 0; i < visspritecount; i++)
+		src[i] = R_GetVisSprite(i);
 
-	// The first's prev and last's next will be set to
-	// nonsense, but are fixed in a moment
-	for (i = 0, dsnext = dsfirst, ds = NULL; i < visspritecount; i++)
+	// Bottom-up merge sort. Ties keep the order the sprites were
+	// projected in, same as the old selection sort did.
+	for (width = 1; width < visspritecount; width <<= 1)
 	{
-		dsprev = ds;
-		ds = dsnext;
-		if (i < visspritecount - 1) dsnext = R_GetVisSprite(i + 1);
+		for (lo = 0; lo < visspritecount; lo += width<<1)
+		{
+			mid = min(lo + width, visspritecount);
+			hi = min(lo + (width<<1), visspritecount);
+			for (l = lo, r = mid, k = lo; k < hi; k++)
+			{
+				if (l < mid && (r >= hi || !VSPRBEFORE(src[r], src[l])))
+					dst[k] = src[l++];
+				else
+					dst[k] = src[r++];
+			}
+		}
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
 
-		ds->next = dsnext;
-		ds->prev = dsprev;
+	for (i = 0; i < visspritecount; i++)
+	{
+		src[i]->next = &vsprsortedhead;
+		src[i]->prev = vsprsortedhead.prev;
+		vsprsortedhead.prev->next = src[i];
+		vsprsortedhead.prev = src[i];
 	}
+}
 
-	// Fix first and last. ds still points to the last one after the loop
-	dsfirst->prev = &unsorted;
-	unsorted.next = dsfirst;
-	if (ds)
-		ds->next = &unsorted;
-	unsorted.prev = ds;
+#undef VSPRBEFORE
 
-	// pull the vissprites out by scale
-	vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
-	for (i = 0; i < visspritecount; i++)
+static drawnode_t *R_CreateDrawNode(drawnode_t *link);
+
+static drawnode_t nodebankhead;
+static drawnode_t nodehead;
+
+//
+// R_NodeHidesSprite
+// True if the drawnode r2 is in front of the sprite, so the sprite has to be
+// drawn before it.
+//
+static boolean R_NodeHidesSprite(drawnode_t *r2, vissprite_t *rover, INT32 sintersect)
+{
+	INT32 i, x1, x2;
+	fixed_t scale;
+
+	if (r2->plane)
 	{
-		bestscale = bestdispoffset = INT32_MAX;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
+		fixed_t planeobjectz, planecameraz;
+		if (r2->plane->minx > rover->x2 || r2->plane->maxx < rover->x1)
+			return false;
+		if (rover->szt > r2->plane->low || rover->sz < r2->plane->high)
+			return false;
+
+#ifdef ESLOPE
+		// Effective height may be different for each comparison in the case of slopes
+		if (r2->plane->slope) {
+			planeobjectz = P_GetZAt(r2->plane->slope, rover->gx, rover->gy);
+			planecameraz = P_GetZAt(r2->plane->slope, viewx, viewy);
+		} else
+#endif
+			planeobjectz = planecameraz = r2->plane->height;
+
+		if (rover->mobjflags & MF_NOCLIPHEIGHT)
 		{
-			if (ds->scale < bestscale)
-			{
-				bestscale = ds->scale;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-			// order visprites of same scale by dispoffset, smallest first
-			else if (ds->scale == bestscale && ds->dispoffset < bestdispoffset)
+			//Objects with NOCLIPHEIGHT can appear halfway in.
+			if (planecameraz < viewz && rover->pz+(rover->thingheight/2) >= planeobjectz)
+				return false;
+			if (planecameraz > viewz && rover->pzt-(rover->thingheight/2) <= planeobjectz)
+				return false;
+		}
+		else
+		{
+			if (planecameraz < viewz && rover->pz >= planeobjectz)
+				return false;
+			if (planecameraz > viewz && rover->pzt <= planeobjectz)
+				return false;
+		}
+
+		// SoM: NOTE: Because a visplane's shape and scale is not directly
+		// bound to any single linedef, a simple poll of it's frontscale is
+		// not adequate. We must check the entire frontscale array for any
+		// part that is in front of the sprite.
+
+		x1 = rover->x1;
+		x2 = rover->x2;
+		if (x1 < r2->plane->minx) x1 = r2->plane->minx;
+		if (x2 > r2->plane->maxx) x2 = r2->plane->maxx;
+
+		if (r2->seg) // if no seg set, assume the whole thing is in front or something stupid
+		{
+			for (i = x1; i <= x2; i++)
 			{
-				bestdispoffset = ds->dispoffset;
-				best = ds;
+				if (r2->seg->frontscale[i] > rover->scale)
+					break;
 			}
+			if (i > x2)
+				return false;
+		}
+
+		return true;
+	}
+	else if (r2->thickseg)
+	{
+		fixed_t topplaneobjectz, topplanecameraz, botplaneobjectz, botplanecameraz;
+		if (rover->x1 > r2->thickseg->x2 || rover->x2 < r2->thickseg->x1)
+			return false;
+
+		scale = r2->thickseg->scale1 > r2->thickseg->scale2 ? r2->thickseg->scale1 : r2->thickseg->scale2;
+		if (scale <= rover->scale)
+			return false;
+		scale = r2->thickseg->scale1 + (r2->thickseg->scalestep * (sintersect - r2->thickseg->x1));
+		if (scale <= rover->scale)
+			return false;
+
+#ifdef ESLOPE
+		if (*r2->ffloor->t_slope) {
+			topplaneobjectz = P_GetZAt(*r2->ffloor->t_slope, rover->gx, rover->gy);
+			topplanecameraz = P_GetZAt(*r2->ffloor->t_slope, viewx, viewy);
+		} else
+#endif
+			topplaneobjectz = topplanecameraz = *r2->ffloor->topheight;
+
+#ifdef ESLOPE
+		if (*r2->ffloor->b_slope) {
+			botplaneobjectz = P_GetZAt(*r2->ffloor->b_slope, rover->gx, rover->gy);
+			botplanecameraz = P_GetZAt(*r2->ffloor->b_slope, viewx, viewy);
+		} else
+#endif
+			botplaneobjectz = botplanecameraz = *r2->ffloor->bottomheight;
+
+		if ((topplanecameraz > viewz && botplanecameraz < viewz) ||
+		    (topplanecameraz < viewz && rover->gzt < topplaneobjectz) ||
+		    (botplanecameraz > viewz && rover->gz > botplaneobjectz))
+			return true;
+	}
+	else if (r2->seg)
+	{
+#if 0 //#ifdef POLYOBJECTS_PLANES
+		if (r2->seg->curline->polyseg && rover->mobj && P_MobjInsidePolyobj(r2->seg->curline->polyseg, rover->mobj)) {
+			// Determine if we need to sort in front of the polyobj, based on the planes. This fixes the issue where
+			// polyobject planes render above the object standing on them. (A bit hacky... but it works.) -Red
+			mobj_t *mo = rover->mobj;
+			sector_t *po = r2->seg->curline->backsector;
+
+			if (po->ceilingheight < viewz && mo->z+mo->height > po->ceilingheight)
+				return false;
+
+			if (po->floorheight > viewz && mo->z < po->floorheight)
+				return false;
+		}
+#endif
+		if (rover->x1 > r2->seg->x2 || rover->x2 < r2->seg->x1)
+			return false;
+
+		scale = r2->seg->scale1 > r2->seg->scale2 ? r2->seg->scale1 : r2->seg->scale2;
+		if (scale <= rover->scale)
+			return false;
+		scale = r2->seg->scale1 + (r2->seg->scalestep * (sintersect - r2->seg->x1));
+
+		if (rover->scale < scale)
+			return true;
+	}
+	else if (r2->sprite)
+	{
+		if (r2->sprite->x1 > rover->x2 || r2->sprite->x2 < rover->x1)
+			return false;
+		if (r2->sprite->szt > rover->sz || r2->sprite->sz < rover->szt)
+			return false;
+
+		if (r2->sprite->scale > rover->scale
+		 || (r2->sprite->scale == rover->scale && r2->sprite->dispoffset > rover->dispoffset))
+			return true;
+	}
+	return false;
+}
+
+// Finding the first node that hides a sprite used to mean walking the whole
+// list for every sprite. Instead, each node is put in whichever of these
+// ranges of screen columns it covers, so a sprite only looks at the nodes
+// that share a range with it, which are the only ones that can overlap it.
+// Every node also carries its position in the list, so the candidates can
+// be tried in list order and the first one that hides the sprite is the same
+// node the full walk would have stopped at.
+#define DRAWNODEBINS 32
+
+typedef struct
+{
+	drawnode_t **nodes; // sorted by order
+	INT32 count, capacity;
+} drawnodebin_t;
+
+static drawnodebin_t drawnodebins[DRAWNODEBINS];
+static INT32 drawnodebinwidth;
+
+static INT32 R_DrawNodeBin(INT32 x)
+{
+	if (x < 0)
+		return 0;
+	if (x >= viewwidth)
+		return DRAWNODEBINS - 1;
+	return x / drawnodebinwidth;
+}
+
+// The screen columns a node covers. Anything that could overlap a sprite at
+// all has to be inside them, even when a visplane's bounds are backwards.
+static void R_DrawNodeColumns(drawnode_t *node, INT32 *x1, INT32 *x2)
+{
+	INT32 swap;
+
+	if (node->plane)
+	{
+		*x1 = node->plane->minx;
+		*x2 = node->plane->maxx;
+	}
+	else if (node->thickseg)
+	{
+		*x1 = node->thickseg->x1;
+		*x2 = node->thickseg->x2;
+	}
+	else if (node->seg)
+	{
+		*x1 = node->seg->x1;
+		*x2 = node->seg->x2;
+	}
+	else if (node->sprite)
+	{
+		*x1 = node->sprite->x1;
+		*x2 = node->sprite->x2;
+	}
+	else
+	{
+		*x1 = 0;
+		*x2 = viewwidth - 1;
+	}
+
+	if (*x1 > *x2)
+	{
+		swap = *x1;
+		*x1 = *x2;
+		*x2 = swap;
+	}
+}
+
+static void R_BinDrawNode(drawnode_t *node)
+{
+	drawnodebin_t *bin;
+	INT32 x1, x2, b, b2, i;
+
+	R_DrawNodeColumns(node, &x1, &x2);
+	b2 = R_DrawNodeBin(x2);
+
+	for (b = R_DrawNodeBin(x1); b <= b2; b++)
+	{
+		bin = &drawnodebins[b];
+		if (bin->count == bin->capacity)
+		{
+			bin->capacity = bin->capacity ? bin->capacity * 2 : 64;
+			bin->nodes = Z_Realloc(bin->nodes, bin->capacity * sizeof (*bin->nodes), PU_STATIC, NULL);
+		}
+
+		// Sprites are put in the middle of the list, so keep the bin in order
+		for (i = bin->count++; i > 0 && bin->nodes[i-1]->order > node->order; i--)
+			bin->nodes[i] = bin->nodes[i-1];
+		bin->nodes[i] = node;
+	}
+}
+
+// Spreads the list's positions out evenly, leaving room between them
+static void R_NumberDrawNodes(void)
+{
+	drawnode_t *node;
+	UINT32 count = 0, gap, order;
+
+	for (node = nodehead.next; node != &nodehead; node = node->next)
+		count++;
+
+	gap = UINT32_MAX / (count + 1);
+	order = 0;
+	for (node = nodehead.next; node != &nodehead; node = node->next)
+		node->order = (order += gap);
+}
+
+// Gives a node that was just linked into the list a position between its
+// neighbours', renumbering everything if they've run out of room.
+static void R_OrderDrawNode(drawnode_t *node)
+{
+	UINT32 lo = (node->prev == &nodehead) ? 0 : node->prev->order;
+	UINT32 hi = (node->next == &nodehead) ? UINT32_MAX : node->next->order;
+
+	if (hi - lo < 2)
+		R_NumberDrawNodes();
+	else
+		node->order = lo + (hi - lo)/2;
+}
+
+static void R_IndexDrawNodes(void)
+{
+	drawnode_t *node;
+	INT32 b;
+
+	drawnodebinwidth = (viewwidth + DRAWNODEBINS - 1) / DRAWNODEBINS;
+	for (b = 0; b < DRAWNODEBINS; b++)
+		drawnodebins[b].count = 0;
+
+	R_NumberDrawNodes();
+	for (node = nodehead.next; node != &nodehead; node = node->next)
+		R_BinDrawNode(node);
+}
+
+//
+// R_FindHidingNode
+// Returns the first node in the list that hides the sprite, or &nodehead if
+// none do, by merging the bins it covers in list order.
+//
+static drawnode_t *R_FindHidingNode(vissprite_t *rover)
+{
+	INT32 cursor[DRAWNODEBINS];
+	INT32 b, b1 = R_DrawNodeBin(rover->x1), b2 = R_DrawNodeBin(rover->x2);
+	INT32 sintersect = (rover->x1 + rover->x2) / 2;
+	drawnodebin_t *bin;
+	drawnode_t *node;
+
+	for (b = b1; b <= b2; b++)
+		cursor[b] = 0;
+
+	for (;;)
+	{
+		node = NULL;
+		for (b = b1; b <= b2; b++)
+		{
+			bin = &drawnodebins[b];
+			if (cursor[b] < bin->count && (!node || bin->nodes[cursor[b]]->order < node->order))
+				node = bin->nodes[cursor[b]];
+		}
+
+		if (!node)
+			return &nodehead;
+
+		// A node that covers several bins is only tried once
+		for (b = b1; b <= b2; b++)
+		{
+			bin = &drawnodebins[b];
+			if (cursor[b] < bin->count && bin->nodes[cursor[b]] == node)
+				cursor[b]++;
 		}
-		best->next->prev = best->prev;
-		best->prev->next = best->next;
-		best->next = &vsprsortedhead;
-		best->prev = vsprsortedhead.prev;
-		vsprsortedhead.prev->next = best;
-		vsprsortedhead.prev = best;
+
+		if (R_NodeHidesSprite(node, rover, sintersect))
+			return node;
 	}
 }
 
 //
 // R_CreateDrawNodes
 // Creates and sorts a list of drawnodes for the scene being rendered.
-static drawnode_t *R_CreateDrawNode(drawnode_t *link);
-
-static drawnode_t nodebankhead;
-static drawnode_t nodehead;
-
+//
 static void R_CreateDrawNodes(void)
 {
 	drawnode_t *entry;
 	drawseg_t *ds;
-	INT32 i, p, best, x1, x2;
+	INT32 i, p, best;
 	fixed_t bestdelta, delta;
 	vissprite_t *rover;
-	drawnode_t *r2;
 	visplane_t *plane;
-	INT32 sintersect;
-	fixed_t scale = 0;
 
 	// Add the 3D floors, thicksides, and masked textures...
 	for (ds = ds_p; ds-- > drawsegs ;)
@@ -1815,171 +2118,19 @@ static void R_CreateDrawNodes(void)
 		return;
 
 	R_SortVisSprites();
+	R_IndexDrawNodes();
+
 	for (rover = vsprsortedhead.prev; rover != &vsprsortedhead; rover = rover->prev)
 	{
 		if (rover->szt > vid.height || rover->sz < 0)
 			continue;
 
-		sintersect = (rover->x1 + rover->x2) / 2;
-
-		for (r2 = nodehead.next; r2 != &nodehead; r2 = r2->next)
-		{
-			if (r2->plane)
-			{
-				fixed_t planeobjectz, planecameraz;
-				if (r2->plane->minx > rover->x2 || r2->plane->maxx < rover->x1)
-					continue;
-				if (rover->szt > r2->plane->low || rover->sz < r2->plane->high)
-					continue;
-
-#ifdef ESLOPE
-				// Effective height may be different for each comparison in the case of slopes
-				if (r2->plane->slope) {
-					planeobjectz = P_GetZAt(r2->plane->slope, rover->gx, rover->gy);
-					planecameraz = P_GetZAt(r2->plane->slope, viewx, viewy);
-				} else
-#endif
-					planeobjectz = planecameraz = r2->plane->height;
-
-				if (rover->mobjflags & MF_NOCLIPHEIGHT)
-				{
-					//Objects with NOCLIPHEIGHT can appear halfway in.
-					if (planecameraz < viewz && rover->pz+(rover->thingheight/2) >= planeobjectz)
-						continue;
-					if (planecameraz > viewz && rover->pzt-(rover->thingheight/2) <= planeobjectz)
-						continue;
-				}
-				else
-				{
-					if (planecameraz < viewz && rover->pz >= planeobjectz)
-						continue;
-					if (planecameraz > viewz && rover->pzt <= planeobjectz)
-						continue;
-				}
-
-				// SoM: NOTE: Because a visplane's shape and scale is not directly
-				// bound to any single linedef, a simple poll of it's frontscale is
-				// not adequate. We must check the entire frontscale array for any
-				// part that is in front of the sprite.
-
-				x1 = rover->x1;
-				x2 = rover->x2;
-				if (x1 < r2->plane->minx) x1 = r2->plane->minx;
-				if (x2 > r2->plane->maxx) x2 = r2->plane->maxx;
-
-				if (r2->seg) // if no seg set, assume the whole thing is in front or something stupid
-				{
-					for (i = x1; i <= x2; i++)
-					{
-						if (r2->seg->frontscale[i] > rover->scale)
-							break;
-					}
-					if (i > x2)
-						continue;
-				}
-
-				entry = R_CreateDrawNode(NULL);
-				(entry->prev = r2->prev)->next = entry;
-				(entry->next = r2)->prev = entry;
-				entry->sprite = rover;
-				break;
-			}
-			else if (r2->thickseg)
-			{
-				fixed_t topplaneobjectz, topplanecameraz, botplaneobjectz, botplanecameraz;
-				if (rover->x1 > r2->thickseg->x2 || rover->x2 < r2->thickseg->x1)
-					continue;
-
-				scale = r2->thickseg->scale1 > r2->thickseg->scale2 ? r2->thickseg->scale1 : r2->thickseg->scale2;
-				if (scale <= rover->scale)
-					continue;
-				scale = r2->thickseg->scale1 + (r2->thickseg->scalestep * (sintersect - r2->thickseg->x1));
-				if (scale <= rover->scale)
-					continue;
-
-#ifdef ESLOPE
-				if (*r2->ffloor->t_slope) {
-					topplaneobjectz = P_GetZAt(*r2->ffloor->t_slope, rover->gx, rover->gy);
-					topplanecameraz = P_GetZAt(*r2->ffloor->t_slope, viewx, viewy);
-				} else
-#endif
-					topplaneobjectz = topplanecameraz = *r2->ffloor->topheight;
-
-#ifdef ESLOPE
-				if (*r2->ffloor->b_slope) {
-					botplaneobjectz = P_GetZAt(*r2->ffloor->b_slope, rover->gx, rover->gy);
-					botplanecameraz = P_GetZAt(*r2->ffloor->b_slope, viewx, viewy);
-				} else
-#endif
-					botplaneobjectz = botplanecameraz = *r2->ffloor->bottomheight;
-
-				if ((topplanecameraz > viewz && botplanecameraz < viewz) ||
-				    (topplanecameraz < viewz && rover->gzt < topplaneobjectz) ||
-				    (botplanecameraz > viewz && rover->gz > botplaneobjectz))
-				{
-					entry = R_CreateDrawNode(NULL);
-					(entry->prev = r2->prev)->next = entry;
-					(entry->next = r2)->prev = entry;
-					entry->sprite = rover;
-					break;
-				}
-			}
-			else if (r2->seg)
-			{
-#if 0 //#ifdef POLYOBJECTS_PLANES
-				if (r2->seg->curline->polyseg && rover->mobj && P_MobjInsidePolyobj(r2->seg->curline->polyseg, rover->mobj)) {
-					// Determine if we need to sort in front of the polyobj, based on the planes. This fixes the issue where
-					// polyobject planes render above the object standing on them. (A bit hacky... but it works.) -Red
-					mobj_t *mo = rover->mobj;
-					sector_t *po = r2->seg->curline->backsector;
-
-					if (po->ceilingheight < viewz && mo->z+mo->height > po->ceilingheight)
-						continue;
-
-					if (po->floorheight > viewz && mo->z < po->floorheight)
-						continue;
-				}
-#endif
-				if (rover->x1 > r2->seg->x2 || rover->x2 < r2->seg->x1)
-					continue;
-
-				scale = r2->seg->scale1 > r2->seg->scale2 ? r2->seg->scale1 : r2->seg->scale2;
-				if (scale <= rover->scale)
-					continue;
-				scale = r2->seg->scale1 + (r2->seg->scalestep * (sintersect - r2->seg->x1));
-
-				if (rover->scale < scale)
-				{
-					entry = R_CreateDrawNode(NULL);
-					(entry->prev = r2->prev)->next = entry;
-					(entry->next = r2)->prev = entry;
-					entry->sprite = rover;
-					break;
-				}
-			}
-			else if (r2->sprite)
-			{
-				if (r2->sprite->x1 > rover->x2 || r2->sprite->x2 < rover->x1)
-					continue;
-				if (r2->sprite->szt > rover->sz || r2->sprite->sz < rover->szt)
-					continue;
-
-				if (r2->sprite->scale > rover->scale
-				 || (r2->sprite->scale == rover->scale && r2->sprite->dispoffset > rover->dispoffset))
-				{
-					entry = R_CreateDrawNode(NULL);
-					(entry->prev = r2->prev)->next = entry;
-					(entry->next = r2)->prev = entry;
-					entry->sprite = rover;
-					break;
-				}
-			}
-		}
-		if (r2 == &nodehead)
-		{
-			entry = R_CreateDrawNode(&nodehead);
-			entry->sprite = rover;
-		}
+		// The sprite goes in front of the first node that hides it, or at
+		// the end if nothing does.
+		entry = R_CreateDrawNode(R_FindHidingNode(rover));
+		entry->sprite = rover;
+		R_OrderDrawNode(entry);
+		R_BinDrawNode(entry);
 	}
 }
 
@@ -1996,6 +2147,8 @@ static drawnode_t *R_CreateDrawNode(drawnode_t *link)
 	else
 		(nodebankhead.next = node->next)->prev = &nodebankhead;
 
+	rendercount[RC_DRAWNODES]++;
+
 	if (link)
 	{
 		node->next = link;
@@ -2255,8 +2408,13 @@ void R_DrawMasked(void)
 {
 	drawnode_t *r2;
 	drawnode_t *next;
+	precise_t timer = R_StartTimer();
+
+	rendercount[RC_VISSPRITES] += visspritecount;
+	rendercount[RC_DRAWSEGS] += (UINT32)(ds_p - drawsegs);
 
 	R_CreateDrawNodes();
+	R_LapTimer(timer, RT_DRAWNODES);
 
 	for (r2 = nodehead.next; r2 != &nodehead; r2 = r2->next)
 	{
@@ -2808,8 +2966,6 @@ next_token:
 			// So just let the function in the while loop take care of it for us.
 		}
 
-		R_FlushTranslationColormapCache();
-
 		CONS_Printf(M_GetText("Added skin '%s'\n"), skin->name);
 #ifdef SKINVALUES
 		skin_cons_t[numskins].value = numskins;
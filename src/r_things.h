@@ -174,6 +174,7 @@ typedef struct drawnode_s
 	drawseg_t *thickseg;
 	ffloor_t *ffloor;
 	vissprite_t *sprite;
+	UINT32 order; // increases along the list, for sorting sprites into it
 
 	struct drawnode_s *next;
 	struct drawnode_s *prev;
@@ -47,6 +47,8 @@ void (*shadecolfunc)(void); // smokie test..
 void (*spanfunc)(void); // span drawer, use a 64x64 tile
 void (*splatfunc)(void); // span drawer w/ transparency
 void (*basespanfunc)(void); // default span func for color mode
+void (*transspanfunc)(void); // translucent span drawer
+void (*fogspanfunc)(void); // fog span drawer
 void (*transtransfunc)(void); // translucent translated column drawer
 void (*twosmultipatchfunc)(void); // for cols with transparent pixels
 void (*twosmultipatchtransfunc)(void); // for cols with transparent pixels AND translucency
@@ -115,6 +117,8 @@ void SCR_SetMode(void)
 	if (true)//vid.bpp == 1) //Always run in 8bpp. todo: remove all 16bpp code?
 	{
 		spanfunc = basespanfunc = R_DrawSpan_8;
+		transspanfunc = R_DrawTranslucentSpan_8;
+		fogspanfunc = R_DrawFogSpan_8;
 		splatfunc = R_DrawSplat_8;
 		transcolfunc = R_DrawTranslatedColumn_8;
 		transtransfunc = R_DrawTranslatedTranslucentColumn_8;
@@ -146,6 +150,14 @@ void SCR_SetMode(void)
 				twosmultipatchfunc = R_Draw2sMultiPatchColumn_8_ASM;
 			}
 		}
+#endif
+#ifdef HAVE_SSE2DRAWERS
+		if (R_SSE2)
+		{
+			spanfunc = basespanfunc = R_DrawSpan_8_SSE2;
+			transspanfunc = R_DrawTranslucentSpan_8_SSE2;
+			fogspanfunc = R_DrawFogSpan_8_SSE2;
+		}
 #endif
 	}
 /*	else if (vid.bpp > 1)
@@ -215,6 +227,8 @@ void SCR_Startup(void)
 
 	if (M_CheckParm("-SSE2"))
 		R_SSE2 = true;
+	if (M_CheckParm("-noSSE2"))
+		R_SSE2 = false;
 
 	M_SetupMemcpy();
 
@@ -2073,6 +2073,20 @@ tic_t I_GetTime (void)
 }
 #endif
 
+//
+// I_GetPreciseTime
+// returns the performance counter, for profiling
+//
+precise_t I_GetPreciseTime(void)
+{
+	return SDL_GetPerformanceCounter();
+}
+
+int I_PreciseToMicros(precise_t d)
+{
+	return (int)(d * 1000000 / SDL_GetPerformanceFrequency());
+}
+
 //
 //I_StartupTimer
 //
@@ -2522,6 +2536,137 @@ const char *I_ClipboardPaste(void)
 	return (const char *)&clipboard_modified;
 }
 
+// Worker threads for I_RunParallel, started the first time they are needed
+#define MAXPARALLELTHREADS 16
+
+static struct
+{
+	SDL_mutex *mutex;
+	SDL_cond *wake; // a new batch of calls is ready
+	SDL_cond *done; // the last call of a batch has returned
+	SDL_Thread *threads[MAXPARALLELTHREADS];
+	INT32 numthreads;
+	UINT32 batch;
+	void (*func)(INT32 index, void *userdata);
+	void *userdata;
+	INT32 next, count, running;
+	SDL_bool quit;
+} parallel;
+
+// Called and returns with parallel.mutex locked
+static void I_RunParallelCalls(void)
+{
+	while (parallel.next < parallel.count)
+	{
+		void (*func)(INT32, void *) = parallel.func;
+		void *userdata = parallel.userdata;
+		INT32 index = parallel.next++;
+
+		SDL_UnlockMutex(parallel.mutex);
+		func(index, userdata);
+		SDL_LockMutex(parallel.mutex);
+
+		if (--parallel.running == 0)
+			SDL_CondBroadcast(parallel.done);
+	}
+}
+
+static int I_ParallelWorker(void *unused)
+{
+	UINT32 batch = 0;
+	(void)unused;
+
+	SDL_LockMutex(parallel.mutex);
+	for (;;)
+	{
+		while (!parallel.quit && parallel.batch == batch)
+			SDL_CondWait(parallel.wake, parallel.mutex);
+		if (parallel.quit)
+			break;
+		batch = parallel.batch;
+		I_RunParallelCalls();
+	}
+	SDL_UnlockMutex(parallel.mutex);
+	return 0;
+}
+
+static void I_ShutdownParallel(void)
+{
+	INT32 i;
+
+	if (!parallel.mutex)
+		return;
+
+	SDL_LockMutex(parallel.mutex);
+	parallel.quit = SDL_TRUE;
+	SDL_CondBroadcast(parallel.wake);
+	SDL_UnlockMutex(parallel.mutex);
+
+	for (i = 0; i < parallel.numthreads; i++)
+		SDL_WaitThread(parallel.threads[i], NULL);
+	parallel.numthreads = 0;
+
+	SDL_DestroyCond(parallel.done);
+	SDL_DestroyCond(parallel.wake);
+	SDL_DestroyMutex(parallel.mutex);
+	parallel.mutex = NULL;
+}
+
+static INT32 I_StartParallelThreads(INT32 wanted)
+{
+	if (wanted > MAXPARALLELTHREADS)
+		wanted = MAXPARALLELTHREADS;
+
+	if (!parallel.mutex)
+	{
+		parallel.mutex = SDL_CreateMutex();
+		parallel.wake = SDL_CreateCond();
+		parallel.done = SDL_CreateCond();
+		if (!parallel.mutex || !parallel.wake || !parallel.done)
+		{
+			I_OutputMsg("I_RunParallel: %s, running single threaded\n", SDL_GetError());
+			return 0;
+		}
+		I_AddExitFunc(I_ShutdownParallel);
+	}
+
+	while (parallel.numthreads < wanted)
+	{
+		SDL_Thread *thread = SDL_CreateThread(I_ParallelWorker, "SRB2 worker", NULL);
+		if (!thread)
+			break;
+		parallel.threads[parallel.numthreads++] = thread;
+	}
+
+	return parallel.numthreads;
+}
+
+void I_RunParallel(INT32 count, void (*func)(INT32 index, void *userdata), void *userdata)
+{
+	INT32 i;
+
+	if (count <= 1 || !I_StartParallelThreads(count - 1))
+	{
+		for (i = 0; i < count; i++)
+			func(i, userdata);
+		return;
+	}
+
+	SDL_LockMutex(parallel.mutex);
+	parallel.func = func;
+	parallel.userdata = userdata;
+	parallel.next = 0;
+	parallel.count = parallel.running = count;
+	parallel.batch++;
+	SDL_CondBroadcast(parallel.wake);
+
+	// Help out rather than just wait
+	I_RunParallelCalls();
+	while (parallel.running)
+		SDL_CondWait(parallel.done, parallel.mutex);
+	SDL_UnlockMutex(parallel.mutex);
+}
+
 /**	\brief	The isWadPathOk function
 
 	\param	path	string path to check
@@ -2690,6 +2690,23 @@ char *I_ClipboardPaste(void)
 	return NULL;
 }
 
+void I_RunParallel(INT32 count, void (*func)(INT32 index, void *userdata), void *userdata)
+{
+	INT32 i;
+	for (i = 0; i < count; i++)
+		func(i, userdata);
+}
+
+precise_t I_GetPreciseTime(void)
+{
+	return SDL_GetTicks();
+}
+
+int I_PreciseToMicros(precise_t d)
+{
+	return (int)(d * 1000);
+}
+
 /**	\brief	The isWadPathOk function
 
 	\param	path	string path to check
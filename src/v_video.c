@@ -25,6 +25,8 @@
 #include "m_misc.h"
 #include "m_random.h"
 #include "doomstat.h"
+#include "i_system.h" // I_GetPreciseTime
+#include "f_finale.h" // F_WipeBenchFrame
 
 #ifdef HWRENDER
 #include "hardware/hw_glob.h"
@@ -240,6 +242,7 @@ void V_SetPalette(INT32 palettenum)
 void V_SetPaletteLump(const char *pal)
 {
 	LoadPalette(pal);
+	V_FlushTextRuns();
 #ifdef HWRENDER
 	if (rendermode != render_soft && rendermode != render_none)
 		HWR_SetPalette(pLocalPalette);
@@ -310,31 +313,144 @@ static UINT8 hudminusalpha[11] = { 10,  9,  9,  8,  8,  7,  7,  6,  6,  5,  5};
 static const UINT8 *v_colormap = NULL;
 static const UINT8 *v_translevel = NULL;
 
-static inline UINT8 standardpdraw(const UINT8 *dest, const UINT8 *source, fixed_t ofs)
+//
+// V_AlphaLevel
+// How translucent something drawn with these flags is, from 0 (opaque) to
+// 10 (invisible). The HUD levels depend on cv_translucenthud.
+//
+static INT32 V_AlphaLevel(INT32 scrn)
 {
-	(void)dest; return source[ofs>>FRACBITS];
+	INT32 alphalevel = ((scrn & V_ALPHAMASK) >> V_ALPHASHIFT);
+
+	if (alphalevel == 13)
+		alphalevel = hudminusalpha[cv_translucenthud.value];
+	else if (alphalevel == 14)
+		alphalevel = 10 - cv_translucenthud.value;
+	else if (alphalevel == 15)
+		alphalevel = hudplusalpha[cv_translucenthud.value];
+
+	return alphalevel;
 }
-static inline UINT8 mappedpdraw(const UINT8 *dest, const UINT8 *source, fixed_t ofs)
+
+// While a text run is being built, V_DrawPatchPost hands the pixels it
+// would have drawn to V_CaptureTextPixel instead (see V_BuildTextRun)
+typedef struct
 {
-	(void)dest; return *(v_colormap + source[ofs>>FRACBITS]);
-}
-static inline UINT8 translucentpdraw(const UINT8 *dest, const UINT8 *source, fixed_t ofs)
+	boolean raster; // false while only finding the bounds
+	boolean failed; // something can't be cached, like a translucent glyph
+	boolean overlaps; // some pixel was drawn twice
+	const UINT8 *screen;
+	INT32 left, top, right, bottom; // inclusive, in screen pixels
+	UINT8 *pixels, *mask;
+} textcapture_t;
+
+static textcapture_t *textcapture = NULL;
+
+static void V_CaptureTextPixel(ptrdiff_t offset, UINT8 pixel)
 {
-	return *(v_translevel + ((source[ofs>>FRACBITS]<<8)&0xff00) + (*dest&0xff));
+	const INT32 row = (INT32)(offset / vid.width), col = (INT32)(offset % vid.width);
+	size_t i;
+
+	if (!textcapture->raster)
+	{
+		if (col < textcapture->left)
+			textcapture->left = col;
+		if (col > textcapture->right)
+			textcapture->right = col;
+		if (row < textcapture->top)
+			textcapture->top = row;
+		if (row > textcapture->bottom)
+			textcapture->bottom = row;
+		return;
+	}
+
+	i = (size_t)(row - textcapture->top) * (textcapture->right - textcapture->left + 1) + (col - textcapture->left);
+	if (textcapture->mask[i])
+		textcapture->overlaps = true;
+	textcapture->mask[i] = 0xff;
+	textcapture->pixels[i] = pixel;
 }
-static inline UINT8 transmappedpdraw(const UINT8 *dest, const UINT8 *source, fixed_t ofs)
+
+// How V_DrawPatchPost writes each pixel
+typedef enum
+{
+	PDRAW_STANDARD,
+	PDRAW_MAPPED,
+	PDRAW_TRANSLUCENT,
+	PDRAW_TRANSMAPPED
+} pdrawmode_t;
+
+#define PATCHPOSTLOOP(pixel, write) \
+	for (ofs = 0; dest < deststop && (ofs>>FRACBITS) < length; ofs += rowfrac, dest += vid.width) \
+	{ \
+		if (dest < destbase) /* don't draw off the top of the screen (CRASH PREVENTION) */ \
+			continue; \
+		pixel; \
+		write; \
+	}
+
+//
+// V_DrawPatchPost
+// Draws one post of a patch down count neighbouring screen columns, which
+// all show the same column of the patch. Scaled up, that's every column,
+// so each row's pixel is looked up once and then written count times.
+//
+static void V_DrawPatchPost(UINT8 *dest, const UINT8 *destbase, const UINT8 *deststop,
+	const UINT8 *source, INT32 length, fixed_t rowfrac, INT32 count, pdrawmode_t mode)
 {
-	return *(v_translevel + (((*(v_colormap + source[ofs>>FRACBITS]))<<8)&0xff00) + (*dest&0xff));
+	fixed_t ofs;
+	UINT8 p;
+	INT32 i;
+
+	if (textcapture)
+	{
+		if (mode == PDRAW_TRANSLUCENT || mode == PDRAW_TRANSMAPPED
+			|| (textcapture->screen && textcapture->screen != destbase))
+		{
+			textcapture->failed = true;
+			return;
+		}
+		textcapture->screen = destbase;
+		PATCHPOSTLOOP(p = (mode == PDRAW_MAPPED) ? v_colormap[source[ofs>>FRACBITS]] : source[ofs>>FRACBITS],
+			for (i = 0; i < count; i++) V_CaptureTextPixel(dest + i - destbase, p))
+		return;
+	}
+
+	switch (mode)
+	{
+		case PDRAW_STANDARD:
+			if (count == 1)
+				PATCHPOSTLOOP(p = source[ofs>>FRACBITS], *dest = p)
+			else
+				PATCHPOSTLOOP(p = source[ofs>>FRACBITS], memset(dest, p, count))
+			break;
+		case PDRAW_MAPPED:
+			if (count == 1)
+				PATCHPOSTLOOP(p = v_colormap[source[ofs>>FRACBITS]], *dest = p)
+			else
+				PATCHPOSTLOOP(p = v_colormap[source[ofs>>FRACBITS]], memset(dest, p, count))
+			break;
+		case PDRAW_TRANSLUCENT:
+			PATCHPOSTLOOP(p = source[ofs>>FRACBITS],
+				for (i = 0; i < count; i++) dest[i] = v_translevel[(p<<8) + dest[i]])
+			break;
+		case PDRAW_TRANSMAPPED:
+			PATCHPOSTLOOP(p = v_colormap[source[ofs>>FRACBITS]],
+				for (i = 0; i < count; i++) dest[i] = v_translevel[(p<<8) + dest[i]])
+			break;
+	}
 }
 
+#undef PATCHPOSTLOOP
+
 // Draws a patch scaled to arbitrary size.
 void V_DrawFixedPatch(fixed_t x, fixed_t y, fixed_t pscale, INT32 scrn, patch_t *patch, const UINT8 *colormap)
 {
-	UINT8 (*patchdrawfunc)(const UINT8*, const UINT8*, fixed_t);
+	pdrawmode_t drawmode;
 	UINT32 alphalevel = 0;
 
-	fixed_t col, ofs, colfrac, rowfrac, fdup;
-	INT32 dupx, dupy;
+	fixed_t col, colfrac, rowfrac, fdup;
+	INT32 dupx, dupy, count;
 	const column_t *column;
 	UINT8 *desttop, *dest, *deststart, *destend;
 	const UINT8 *source, *deststop;
@@ -353,32 +469,22 @@ void V_DrawFixedPatch(fixed_t x, fixed_t y, fixed_t pscale, INT32 scrn, patch_t
 	}
 #endif
 
-	patchdrawfunc = standardpdraw;
+	drawmode = PDRAW_STANDARD;
 
 	v_translevel = NULL;
-	if ((alphalevel = ((scrn & V_ALPHAMASK) >> V_ALPHASHIFT)))
+	if ((alphalevel = V_AlphaLevel(scrn)))
 	{
-		if (alphalevel == 13)
-			alphalevel = hudminusalpha[cv_translucenthud.value];
-		else if (alphalevel == 14)
-			alphalevel = 10 - cv_translucenthud.value;
-		else if (alphalevel == 15)
-			alphalevel = hudplusalpha[cv_translucenthud.value];
-
 		if (alphalevel >= 10)
 			return; // invis
-	}
-	if (alphalevel)
-	{
 		v_translevel = transtables + ((alphalevel-1)<<FF_TRANSSHIFT);
-		patchdrawfunc = translucentpdraw;
+		drawmode = PDRAW_TRANSLUCENT;
 	}
 
 	v_colormap = NULL;
 	if (colormap)
 	{
 		v_colormap = colormap;
-		patchdrawfunc = (v_translevel) ? transmappedpdraw : mappedpdraw;
+		drawmode = (v_translevel) ? PDRAW_TRANSMAPPED : PDRAW_MAPPED;
 	}
 
 	dupx = vid.dupx;
@@ -504,9 +610,10 @@ void V_DrawFixedPatch(fixed_t x, fixed_t y, fixed_t pscale, INT32 scrn, patch_t
 	deststart = desttop;
 	destend = desttop + pwidth;
 
-	for (col = 0; (col>>FRACBITS) < SHORT(patch->width); col += colfrac, ++offx, desttop++)
+	for (col = 0; (col>>FRACBITS) < SHORT(patch->width); col += colfrac*count, offx += count, desttop += count)
 	{
 		INT32 topdelta, prevdelta = -1;
+		count = 1;
 		if (scrn & V_FLIP) // offx is measured from right edge instead of left
 		{
 			if (x+pwidth-offx < 0) // don't draw off the left of the screen (WRAP PREVENTION)
@@ -521,6 +628,13 @@ void V_DrawFixedPatch(fixed_t x, fixed_t y, fixed_t pscale, INT32 scrn, patch_t
 			if (x+offx >= vid.width) // don't draw off the right of the screen (WRAP PREVENTION)
 				break;
 		}
+
+		// Take in the following screen columns that show this same patch
+		// column too, as long as they're still on the screen
+		while (((col + colfrac*count)>>FRACBITS) == (col>>FRACBITS)
+			&& ((scrn & V_FLIP) ? (x+pwidth-(offx+count) >= 0) : (x+offx+count < vid.width)))
+			count++;
+
 		column = (const column_t *)((const UINT8 *)(patch) + LONG(patch->columnofs[col>>FRACBITS]));
 
 		while (column->topdelta != 0xff)
@@ -531,16 +645,11 @@ void V_DrawFixedPatch(fixed_t x, fixed_t y, fixed_t pscale, INT32 scrn, patch_t
 			prevdelta = topdelta;
 			source = (const UINT8 *)(column) + 3;
 			dest = desttop;
-			if (scrn & V_FLIP)
-				dest = deststart + (destend - desttop);
+			if (scrn & V_FLIP) // the last of the columns is the leftmost
+				dest = deststart + (destend - desttop) - (count - 1);
 			dest += FixedInt(FixedMul(topdelta<<FRACBITS,fdup))*vid.width;
 
-			for (ofs = 0; dest < deststop && (ofs>>FRACBITS) < column->length; ofs += rowfrac)
-			{
-				if (dest >= screens[scrn&V_PARAMMASK]) // don't draw off the top of the screen (CRASH PREVENTION)
-					*dest = patchdrawfunc(dest, source, ofs);
-				dest += vid.width;
-			}
+			V_DrawPatchPost(dest, screens[scrn&V_PARAMMASK], deststop, source, column->length, rowfrac, count, drawmode);
 			column = (const column_t *)((const UINT8 *)column + column->length + 4);
 		}
 	}
@@ -759,6 +868,16 @@ static void V_BlitScaledPic(INT32 rx1, INT32 ry1, INT32 scrn, pic_t * pic)
 	}
 }
 
+//
+// V_MapPixels
+// Runs count pixels through a 256 byte table.
+//
+static void V_MapPixels(UINT8 *buf, size_t count, const UINT8 *table)
+{
+	for (; count; count--, buf++)
+		*buf = table[*buf];
+}
+
 //
 // Fills a box of pixels with a single color, NOTE: scaled to screen size
 //
@@ -838,6 +957,13 @@ void V_DrawFill(INT32 x, INT32 y, INT32 w, INT32 h, INT32 c)
 
 	c &= 255;
 
+	// Whole rows are one block
+	if (w == vid.width && vid.bpp == 1)
+	{
+		memset(dest, c, (size_t)w * h * vid.bpp);
+		return;
+	}
+
 	for (;(--h >= 0) && dest < deststop; dest += vid.width)
 		memset(dest, c, w * vid.bpp);
 }
@@ -881,8 +1007,9 @@ static UINT32 V_GetHWConsBackColor(void)
 void V_DrawFillConsoleMap(INT32 x, INT32 y, INT32 w, INT32 h, INT32 c)
 {
 	UINT8 *dest;
-	INT32 u, v;
+	INT32 v;
 	UINT8 *fadetable;
+	UINT8 maptable[256];
 	UINT32 alphalevel = 0;
 
 	if (rendermode == render_none)
@@ -971,14 +1098,13 @@ void V_DrawFillConsoleMap(INT32 x, INT32 y, INT32 w, INT32 h, INT32 c)
 	w = min(w, vid.width);
 	h = min(h, vid.height);
 	fadetable = ((UINT8 *)transtables + ((alphalevel-1)<<FF_TRANSSHIFT) + (c*256));
+
+	// Both lookups folded into one table
+	for (v = 0; v < 256; v++)
+		maptable[v] = alphalevel ? fadetable[consolebgmap[v]] : consolebgmap[v];
+
 	for (v = 0; v < h; v++, dest += vid.width)
-		for (u = 0; u < w; u++)
-		{
-			if (!alphalevel)
-				dest[u] = consolebgmap[dest[u]];
-			else
-				dest[u] = fadetable[consolebgmap[dest[u]]];
-		}
+		V_MapPixels(dest, w, maptable);
 }
 
 //
@@ -1098,8 +1224,6 @@ void V_DrawPatchFill(patch_t *pat)
 void V_DrawFadeScreen(void)
 {
 	const UINT8 *fadetable = (UINT8 *)colormaps + 16*256;
-	const UINT8 *deststop = screens[0] + vid.rowbytes * vid.height;
-	UINT8 *buf = screens[0];
 
 #ifdef HWRENDER
 	if (rendermode != render_soft && rendermode != render_none)
@@ -1111,15 +1235,12 @@ void V_DrawFadeScreen(void)
 
 	// heavily simplified -- we don't need to know x or y
 	// position when we're doing a full screen fade
-	for (; buf < deststop; ++buf)
-		*buf = fadetable[*buf];
+	V_MapPixels(screens[0], vid.rowbytes * vid.height, fadetable);
 }
 
 // Simple translucency with one color, over a set number of lines starting from the top.
 void V_DrawFadeConsBack(INT32 plines)
 {
-	UINT8 *deststop, *buf;
-
 #ifdef HWRENDER // not win32 only 19990829 by Kin
 	if (rendermode != render_soft && rendermode != render_none)
 	{
@@ -1131,9 +1252,8 @@ void V_DrawFadeConsBack(INT32 plines)
 
 	// heavily simplified -- we don't need to know x or y position,
 	// just the stop position
-	deststop = screens[0] + vid.rowbytes * min(plines, vid.height);
-	for (buf = screens[0]; buf < deststop; ++buf)
-		*buf = consolebgmap[*buf];
+	if (plines > 0)
+		V_MapPixels(screens[0], vid.rowbytes * min(plines, vid.height), consolebgmap);
 }
 
 // Gets string colormap, used for 0x80 color codes
@@ -1282,6 +1402,327 @@ char *V_WordWrap(INT32 x, INT32 w, INT32 option, const char *string)
 	return newstring;
 }
 
+// ==========================================================================
+//                            TEXT RUN CACHE
+// ==========================================================================
+
+// Most text is drawn the same, in the same place, frame after frame: the
+// console, chat, menus and HUD labels. The second time a string is drawn,
+// its glyphs are drawn once more into a text run instead, which remembers
+// which pixels they set and to what. From then on the string is a masked
+// copy of the run onto the screen, blended there if it's translucent.
+// Runs hold palette indexes, so only a new palette lump invalidates them.
+
+#define NUMTEXTRUNS 256
+#define TEXTRUNLEN 255 // longer strings are always drawn a glyph at a time
+#define TEXTRUNAREA (256*1024) // and so are runs covering more pixels than this
+#define TEXTRUNMEMORY (16<<20) // flush everything when runs take up more than this
+
+typedef enum
+{
+	TEXTRUN_STRING,
+	TEXTRUN_SMALLSTRING,
+	TEXTRUN_THINSTRING,
+	TEXTRUN_CONSOLE
+} textrunfont_t;
+
+typedef struct
+{
+	// what was drawn
+	boolean used;
+	UINT32 hash;
+	textrunfont_t font;
+	INT32 x, y, option; // option without the translucency
+	INT32 charwidth, charflags; // console lines only
+	boolean lowercase; // console lines only
+	size_t len;
+	char text[TEXTRUNLEN+1];
+
+	// what it looks like
+	boolean built, uncacheable, overlaps;
+	INT32 screen, left, top, width, height;
+	UINT8 *pixels; // zero where the mask is clear
+	UINT8 *mask; // 0xff where a glyph set the pixel
+	size_t size;
+} textrun_t;
+
+static textrun_t textruns[NUMTEXTRUNS];
+static size_t textrunmemory = 0;
+static INT32 textrunwidth = 0, textrunheight = 0, textrundupx = 0, textrundupy = 0;
+
+//
+// V_FlushTextRuns
+// Forgets all text runs. Needed when the font, the palette or the
+// resolution changes.
+//
+void V_FlushTextRuns(void)
+{
+	INT32 i;
+
+	for (i = 0; i < NUMTEXTRUNS; i++)
+	{
+		if (textruns[i].pixels)
+		{
+			Z_Free(textruns[i].pixels);
+			Z_Free(textruns[i].mask);
+		}
+		memset(&textruns[i], 0, sizeof (textrun_t));
+	}
+	textrunmemory = 0;
+}
+
+// Draws the glyphs of a run the normal way, for V_BuildTextRun to capture
+static void V_DrawTextRunGlyphs(const textrun_t *run)
+{
+	size_t i, count = 0;
+
+	switch (run->font)
+	{
+		case TEXTRUN_STRING:
+			V_DrawString(run->x, run->y, run->option, run->text);
+			break;
+		case TEXTRUN_SMALLSTRING:
+			V_DrawSmallString(run->x, run->y, run->option, run->text);
+			break;
+		case TEXTRUN_THINSTRING:
+			V_DrawThinString(run->x, run->y, run->option, run->text);
+			break;
+		case TEXTRUN_CONSOLE:
+			// the text is what the line's characters took up, color codes included
+			for (i = 0; i < run->len; i++)
+				if (!(run->text[i] & 0x80))
+					count++;
+			V_DrawConsoleLine(run->x, run->y, run->charflags, run->option, run->charwidth,
+				(const UINT8 *)run->text, count, run->lowercase);
+			break;
+	}
+}
+
+//
+// V_BuildTextRun
+// Draws the run's glyphs twice with V_DrawPatchPost captured: once to find
+// the rectangle they cover, and once into the run itself.
+//
+static boolean V_BuildTextRun(textrun_t *run)
+{
+	textcapture_t capture;
+	size_t area = 0;
+	INT32 i;
+
+	memset(&capture, 0, sizeof (capture));
+	capture.left = vid.width;
+	capture.top = vid.height;
+	capture.right = capture.bottom = -1;
+
+	textcapture = &capture;
+	V_DrawTextRunGlyphs(run);
+
+	if (!capture.failed && capture.right >= capture.left)
+	{
+		area = (size_t)(capture.right - capture.left + 1) * (capture.bottom - capture.top + 1);
+		if (area > TEXTRUNAREA)
+			capture.failed = true;
+		else
+		{
+			if (run->size < area)
+			{
+				if (run->pixels)
+				{
+					Z_Free(run->pixels);
+					Z_Free(run->mask);
+				}
+				textrunmemory += 2*(area - run->size);
+				run->pixels = Z_Malloc(area, PU_STATIC, NULL);
+				run->mask = Z_Malloc(area, PU_STATIC, NULL);
+				run->size = area;
+			}
+			memset(run->pixels, 0, area);
+			memset(run->mask, 0, area);
+
+			capture.raster = true;
+			capture.pixels = run->pixels;
+			capture.mask = run->mask;
+			V_DrawTextRunGlyphs(run);
+		}
+	}
+
+	textcapture = NULL;
+
+	run->screen = 0;
+	if (area)
+	{
+		for (i = 0; i < NUMSCREENS; i++)
+			if (screens[i] == capture.screen)
+				break;
+		if (i == NUMSCREENS)
+			capture.failed = true;
+		run->screen = i;
+	}
+
+	if (capture.failed)
+	{
+		run->uncacheable = true;
+		return false;
+	}
+
+	run->left = capture.left;
+	run->top = capture.top;
+	run->width = area ? capture.right - capture.left + 1 : 0;
+	run->height = area ? capture.bottom - capture.top + 1 : 0;
+	run->overlaps = capture.overlaps;
+	run->built = true;
+	return true;
+}
+
+//
+// V_BlitTextRun
+// Copies the pixels the run's glyphs set onto the screen, a row at a time.
+// Opaque runs are merged through the mask eight pixels at once.
+//
+static void V_BlitTextRun(const textrun_t *run, const UINT8 *translevel)
+{
+	UINT8 *dest;
+	const UINT8 *pixels = run->pixels, *mask = run->mask;
+	UINT64 d, p, m;
+	INT32 row, i;
+
+	if (!run->width)
+		return;
+
+	dest = screens[run->screen] + run->top*vid.width + run->left;
+
+	for (row = 0; row < run->height; row++, dest += vid.width, pixels += run->width, mask += run->width)
+	{
+		if (translevel)
+		{
+			for (i = 0; i < run->width; i++)
+				if (mask[i])
+					dest[i] = translevel[(pixels[i]<<8) + dest[i]];
+			continue;
+		}
+
+		for (i = 0; i + 8 <= run->width; i += 8)
+		{
+			memcpy(&d, dest + i, 8);
+			memcpy(&p, pixels + i, 8);
+			memcpy(&m, mask + i, 8);
+			d = (d & ~m) | p;
+			memcpy(dest + i, &d, 8);
+		}
+		for (; i < run->width; i++)
+			dest[i] = (UINT8)((dest[i] & ~mask[i]) | pixels[i]);
+	}
+}
+
+//
+// V_DrawTextRun
+// Draws text from its run, if it has one. Returns false if the caller
+// needs to draw it a glyph at a time; the first time text is seen, that
+// just remembers it so the next time can build its run.
+//
+static boolean V_DrawTextRun(textrunfont_t font, INT32 x, INT32 y, INT32 option,
+	INT32 charwidth, INT32 charflags, boolean lowercase, const char *text, size_t len)
+{
+	textrun_t *run;
+	UINT32 hash = 2166136261u;
+	INT32 alphalevel;
+	size_t i;
+
+	if (textcapture || rendermode != render_soft || len > TEXTRUNLEN)
+		return false;
+
+	if (vid.width != textrunwidth || vid.height != textrunheight
+		|| vid.dupx != textrundupx || vid.dupy != textrundupy
+		|| textrunmemory > TEXTRUNMEMORY)
+	{
+		V_FlushTextRuns();
+		textrunwidth = vid.width;
+		textrunheight = vid.height;
+		textrundupx = vid.dupx;
+		textrundupy = vid.dupy;
+	}
+
+	alphalevel = V_AlphaLevel(option);
+	option &= ~V_ALPHAMASK;
+
+	for (i = 0; i < len; i++)
+		hash = (hash ^ (UINT8)text[i]) * 16777619u;
+	hash = (hash ^ (UINT32)font) * 16777619u;
+	hash = (hash ^ (UINT32)x) * 16777619u;
+	hash = (hash ^ (UINT32)y) * 16777619u;
+	hash = (hash ^ (UINT32)option) * 16777619u;
+	hash = (hash ^ (UINT32)charwidth) * 16777619u;
+	hash = (hash ^ (UINT32)charflags) * 16777619u;
+	hash = (hash ^ (UINT32)lowercase) * 16777619u;
+
+	run = &textruns[hash % NUMTEXTRUNS];
+	if (!run->used || run->hash != hash || run->font != font || run->x != x || run->y != y
+		|| run->option != option || run->charwidth != charwidth || run->charflags != charflags
+		|| run->lowercase != lowercase || run->len != len || memcmp(run->text, text, len))
+	{
+		run->used = true;
+		run->hash = hash;
+		run->font = font;
+		run->x = x;
+		run->y = y;
+		run->option = option;
+		run->charwidth = charwidth;
+		run->charflags = charflags;
+		run->lowercase = lowercase;
+		run->len = len;
+		memcpy(run->text, text, len);
+		run->text[len] = '\0';
+		run->built = run->uncacheable = false;
+		return false;
+	}
+
+	if (run->uncacheable)
+		return false;
+	if (alphalevel >= 10)
+		return true; // invisible
+	if (!run->built && !V_BuildTextRun(run))
+		return false;
+	if (alphalevel && run->overlaps)
+		return false; // each glyph blends with the one under it
+
+	V_BlitTextRun(run, alphalevel ? transtables + ((alphalevel-1)<<FF_TRANSSHIFT) : NULL);
+	return true;
+}
+
+//
+// V_DrawConsoleLine
+// Draws count characters from a line of the console's text buffer, one
+// every charwidth pixels. Color codes color the characters after them
+// without taking a place; the color in effect at the end is returned.
+//
+INT32 V_DrawConsoleLine(INT32 x, INT32 y, INT32 charflags, INT32 option, INT32 charwidth,
+	const UINT8 *line, size_t count, boolean lowercase)
+{
+	const UINT8 *p = line;
+	INT32 endflags = charflags;
+	size_t c;
+
+	for (c = 0; c < count; c++, p++)
+		while (*p & 0x80)
+			endflags = (*p++ & 0x7f) << V_CHARCOLORSHIFT;
+
+	if (V_DrawTextRun(TEXTRUN_CONSOLE, x, y, option, charwidth, charflags, lowercase,
+		(const char *)line, (size_t)(p - line)))
+		return endflags;
+
+	for (c = 0, p = line; c < count; c++, x += charwidth, p++)
+	{
+		while (*p & 0x80)
+		{
+			charflags = (*p & 0x7f) << V_CHARCOLORSHIFT;
+			p++;
+		}
+		V_DrawCharacter(x, y, (INT32)(*p) | charflags | option, lowercase);
+	}
+
+	return charflags;
+}
+
 //
 // Write a string using the hu_font
 // NOTE: the text is centered for screens larger than the base width
@@ -1295,6 +1736,9 @@ void V_DrawString(INT32 x, INT32 y, INT32 option, const char *string)
 	INT32 spacewidth = 4, charwidth = 0;
 
 	INT32 lowercase = (option & V_ALLOWLOWERCASE);
+	if (V_DrawTextRun(TEXTRUN_STRING, x, y, option, 0, 0, false, string, strlen(string)))
+		return;
+
 	option &= ~V_FLIP; // which is also shared with V_ALLOWLOWERCASE...
 
 	if (option & V_NOSCALESTART)
@@ -1410,6 +1854,9 @@ void V_DrawSmallString(INT32 x, INT32 y, INT32 option, const char *string)
 	INT32 spacewidth = 2, charwidth = 0;
 
 	INT32 lowercase = (option & V_ALLOWLOWERCASE);
+	if (V_DrawTextRun(TEXTRUN_SMALLSTRING, x, y, option, 0, 0, false, string, strlen(string)))
+		return;
+
 	option &= ~V_FLIP; // which is also shared with V_ALLOWLOWERCASE...
 
 	if (option & V_NOSCALESTART)
@@ -1517,6 +1964,9 @@ void V_DrawThinString(INT32 x, INT32 y, INT32 option, const char *string)
 	INT32 spacewidth = 2, charwidth = 0;
 
 	INT32 lowercase = (option & V_ALLOWLOWERCASE);
+	if (V_DrawTextRun(TEXTRUN_THINSTRING, x, y, option, 0, 0, false, string, strlen(string)))
+		return;
+
 	option &= ~V_FLIP; // which is also shared with V_ALLOWLOWERCASE...
 
 	if (option & V_NOSCALESTART)
@@ -2035,10 +2485,72 @@ boolean *heatshifter = NULL;
 INT32 lastheight = 0;
 INT32 heatindex[2] = { 0, 0 };
 
+//
+// V_ShiftRow
+// Moves a row of pixels sideways in place, by up to its width either way,
+// filling in the gap it leaves with the pixel that was at that edge.
+//
+static void V_ShiftRow(UINT8 *row, INT32 width, INT32 shift)
+{
+	UINT8 edge;
+
+	if (shift > 0) // right
+	{
+		edge = row[0];
+		memmove(row + shift, row, width - shift);
+		memset(row, edge, shift);
+	}
+	else if (shift < 0) // left
+	{
+		shift = -shift;
+		edge = row[width - 1];
+		memmove(row, row + shift, width - shift);
+		memset(row + width - shift, edge, shift);
+	}
+}
+
+//
+// V_SwapRows
+// Swaps two rows of pixels, eight at a time.
+//
+static void V_SwapRows(UINT8 *a, UINT8 *b, size_t count)
+{
+	UINT64 pa, pb;
+	UINT8 p;
+
+	for (; count >= 8; count -= 8, a += 8, b += 8)
+	{
+		memcpy(&pa, a, 8);
+		memcpy(&pb, b, 8);
+		memcpy(a, &pb, 8);
+		memcpy(b, &pa, 8);
+	}
+
+	for (; count; count--, a++, b++)
+	{
+		p = *a;
+		*a = *b;
+		*b = p;
+	}
+}
+
+//
+// V_BlurMotion
+// Blends the screen into what was left of the frames before it, and
+// writes the result to both in the same pass.
+//
+static void V_BlurMotion(UINT8 *scr, UINT8 *history, size_t count, const UINT8 *transme)
+{
+	for (; count; count--, scr++, history++)
+		*history = *scr = colormaps[transme[(*scr << 8) + *history]];
+}
+
 //
 // V_DoPostProcessor
 //
 // Perform a particular image postprocessing function.
+// Everything but motion blur works on the screen in place; motion blur
+// keeps the frames it blends with in screens[4].
 //
 #include "p_local.h"
 void V_DoPostProcessor(INT32 view, postimg_t type, INT32 param)
@@ -2072,97 +2584,40 @@ void V_DoPostProcessor(INT32 view, postimg_t type, INT32 param)
 
 	if (type == postimg_water)
 	{
-		UINT8 *tmpscr = screens[4];
 		UINT8 *srcscr = screens[0];
 		INT32 y;
 		angle_t disStart = (leveltime * 128) & FINEMASK; // in 0 to FINEANGLE
-		INT32 newpix;
 		INT32 sine;
-		//UINT8 *transme = transtables + ((tr_trans50-1)<<FF_TRANSSHIFT);
 
 		for (y = yoffset; y < yoffset+height; y++)
 		{
 			sine = (FINESINE(disStart)*5)>>FRACBITS;
-			newpix = abs(sine);
 
-			if (sine < 0)
-			{
-				M_Memcpy(&tmpscr[y*vid.width+newpix], &srcscr[y*vid.width], vid.width-newpix);
-
-				// Cleanup edge
-				while (newpix)
-				{
-					tmpscr[y*vid.width+newpix] = srcscr[y*vid.width];
-					newpix--;
-				}
-			}
-			else
-			{
-				M_Memcpy(&tmpscr[y*vid.width+0], &srcscr[y*vid.width+sine], vid.width-newpix);
-
-				// Cleanup edge
-				while (newpix)
-				{
-					tmpscr[y*vid.width+vid.width-newpix] = srcscr[y*vid.width+(vid.width-1)];
-					newpix--;
-				}
-			}
-
-/*
-Unoptimized version
-			for (x = 0; x < vid.width*vid.bpp; x++)
-			{
-				newpix = (x + sine);
+			// each row is shifted the other way from the sine, with its edge pixel repeated
+			V_ShiftRow(&srcscr[y*vid.width], vid.width, -sine);
 
-				if (newpix < 0)
-					newpix = 0;
-				else if (newpix >= vid.width)
-					newpix = vid.width-1;
-
-				tmpscr[y*vid.width + x] = srcscr[y*vid.width+newpix]; // *(transme + (srcscr[y*vid.width+x]<<8) + srcscr[y*vid.width+newpix]);
-			}*/
 			disStart += 22;//the offset into the displacement map, increment each game loop
 			disStart &= FINEMASK; //clip it to FINEMASK
 		}
-
-		VID_BlitLinearScreen(tmpscr+vid.width*vid.bpp*yoffset, screens[0]+vid.width*vid.bpp*yoffset,
-				vid.width*vid.bpp, height, vid.width*vid.bpp, vid.width);
 	}
 	else if (type == postimg_motion) // Motion Blur!
 	{
-		UINT8 *tmpscr = screens[4];
-		UINT8 *srcscr = screens[0];
-		INT32 x, y;
-
 		// TODO: Add a postimg_param so that we can pick the translucency level...
 		UINT8 *transme = transtables + ((param-1)<<FF_TRANSSHIFT);
 
-		for (y = yoffset; y < yoffset+height; y++)
-		{
-			for (x = 0; x < vid.width; x++)
-			{
-				tmpscr[y*vid.width + x]
-					=     colormaps[*(transme     + (srcscr   [y*vid.width+x ] <<8) + (tmpscr[y*vid.width+x]))];
-			}
-		}
-		VID_BlitLinearScreen(tmpscr+vid.width*vid.bpp*yoffset, screens[0]+vid.width*vid.bpp*yoffset,
-				vid.width*vid.bpp, height, vid.width*vid.bpp, vid.width);
+		V_BlurMotion(screens[0] + vid.width*yoffset, screens[4] + vid.width*yoffset,
+			(size_t)vid.width*height, transme);
 	}
 	else if (type == postimg_flip) // Flip the screen upside-down
 	{
-		UINT8 *tmpscr = screens[4];
 		UINT8 *srcscr = screens[0];
 		INT32 y, y2;
 
-		for (y = yoffset, y2 = yoffset+height - 1; y < yoffset+height; y++, y2--)
-			M_Memcpy(&tmpscr[y2*vid.width], &srcscr[y*vid.width], vid.width);
-
-		VID_BlitLinearScreen(tmpscr+vid.width*vid.bpp*yoffset, screens[0]+vid.width*vid.bpp*yoffset,
-				vid.width*vid.bpp, height, vid.width*vid.bpp, vid.width);
+		for (y = yoffset, y2 = yoffset+height - 1; y < y2; y++, y2--)
+			V_SwapRows(&srcscr[y*vid.width], &srcscr[y2*vid.width], vid.width);
 	}
 	else if (type == postimg_heat) // Heat wave
 	{
-		UINT8 *tmpscr = screens[4];
 		UINT8 *srcscr = screens[0];
 		INT32 y;
 
@@ -2187,24 +2642,228 @@ Unoptimized version
 		for (y = yoffset; y < yoffset+height; y++)
 		{
 			if (heatshifter[heatindex[view]++])
-			{
-				// Shift this row of pixels to the right by 2
-				tmpscr[y*vid.width] = srcscr[y*vid.width];
-				M_Memcpy(&tmpscr[y*vid.width+vid.dupx], &srcscr[y*vid.width], vid.width-vid.dupx);
-			}
-			else
-				M_Memcpy(&tmpscr[y*vid.width], &srcscr[y*vid.width], vid.width);
+				V_ShiftRow(&srcscr[y*vid.width], vid.width, vid.dupx); // Shift this row of pixels to the right by 2
 
 			heatindex[view] %= height;
 		}
 
 		heatindex[view]++;
 		heatindex[view] %= vid.height;
+	}
+#endif
+}
+
+// ==========================================================================
+//                   2D DRAWING BENCHMARK
+// ==========================================================================
+
+static void V_BenchFill(INT32 frame)
+{
+	V_DrawFill(4, 4, BASEVIDWIDTH - 8, BASEVIDHEIGHT - 8, frame & 255);
+}
+
+static void V_BenchFadeScreen(INT32 frame)
+{
+	(void)frame;
+	V_DrawFadeScreen();
+}
+
+static void V_BenchFadeConsBack(INT32 frame)
+{
+	(void)frame;
+	V_DrawFadeConsBack(vid.height);
+}
 
-		VID_BlitLinearScreen(tmpscr+vid.width*vid.bpp*yoffset, screens[0]+vid.width*vid.bpp*yoffset,
-				vid.width*vid.bpp, height, vid.width*vid.bpp, vid.width);
+static void V_BenchFillConsoleMap(INT32 frame)
+{
+	V_DrawFillConsoleMap(4, 4, BASEVIDWIDTH - 8, BASEVIDHEIGHT - 8, (frame & 255)|V_TRANSLUCENT);
+}
+
+// Covers the screen in copies of a font character, like a page of text
+static void V_BenchPatches(INT32 frame, INT32 flags, fixed_t scale, const UINT8 *colormap)
+{
+	patch_t *patch = hu_font['S' - HU_FONTSTART];
+	INT32 x, y;
+
+	for (y = 0; y < BASEVIDHEIGHT; y += 10)
+		for (x = 0; x < BASEVIDWIDTH; x += 8)
+			V_DrawFixedPatch((x + (frame & 7))<<FRACBITS, y<<FRACBITS, scale, flags, patch, colormap);
+}
+
+static void V_BenchPatch(INT32 frame)
+{
+	V_BenchPatches(frame, 0, FRACUNIT, NULL);
+}
+
+static void V_BenchMappedPatch(INT32 frame)
+{
+	V_BenchPatches(frame, 0, FRACUNIT, V_GetStringColormap(V_REDMAP));
+}
+
+static void V_BenchTransPatch(INT32 frame)
+{
+	V_BenchPatches(frame, V_TRANSLUCENT, FRACUNIT, NULL);
+}
+
+static void V_BenchFlippedPatch(INT32 frame)
+{
+	V_BenchPatches(frame, V_FLIP, FRACUNIT, NULL);
+}
+
+static void V_BenchScaledPatch(INT32 frame)
+{
+	V_BenchPatches(frame, 0, FRACUNIT*3/2, NULL);
+}
+
+// A screenful of the same text each frame, which is blitted from text runs
+static void V_BenchStrings(INT32 frame, INT32 flags)
+{
+	INT32 y;
+
+	(void)frame;
+	for (y = 0; y < BASEVIDHEIGHT; y += 10)
+		V_DrawString(0, y, flags|V_ALLOWLOWERCASE, "The quick brown fox jumps over the lazy dog");
+}
+
+static void V_BenchString(INT32 frame)
+{
+	V_BenchStrings(frame, 0);
+}
+
+static void V_BenchTransString(INT32 frame)
+{
+	V_BenchStrings(frame, V_TRANSLUCENT);
+}
+
+// Text that changes every frame, which never gets a text run
+static void V_BenchChangingString(INT32 frame)
+{
+	char text[64];
+	INT32 y;
+
+	for (y = 0; y < BASEVIDHEIGHT; y += 10)
+	{
+		sprintf(text, "Frame %d, line %d: the lazy dog", frame, y/10);
+		V_DrawString(0, y, V_ALLOWLOWERCASE, text);
 	}
+}
+
+static void V_BenchWater(INT32 frame)
+{
+	(void)frame;
+	V_DoPostProcessor(0, postimg_water, 0);
+}
+
+static void V_BenchFlip(INT32 frame)
+{
+	(void)frame;
+	V_DoPostProcessor(0, postimg_flip, 0);
+}
+
+#if NUMSCREENS >= 5
+static void V_BenchMotion(INT32 frame)
+{
+	if (!frame) // what motion blur blends with
+		memset(screens[4], 0, vid.rowbytes * vid.height);
+	V_DoPostProcessor(0, postimg_motion, tr_trans50);
+}
+
+// A level wipe, between two screens that differ everywhere
+static void V_BenchWipe(INT32 frame)
+{
+	size_t i;
+
+	if (!frame)
+		for (i = 0; i < vid.rowbytes * vid.height; i++)
+		{
+			screens[3][i] = (UINT8)(i ^ (i >> 7));
+			screens[4][i] = (UINT8)(i * 13);
+		}
+	if (!F_WipeBenchFrame(0, (UINT8)(frame % 8)))
+		F_WipeBenchFrame(0, 0);
+}
+#endif
+
+typedef struct
+{
+	const char *name;
+	void (*func)(INT32 frame);
+} hudbench_t;
+
+static hudbench_t hudbenches[] =
+{
+	{"V_DrawFill", V_BenchFill},
+	{"V_DrawFadeScreen", V_BenchFadeScreen},
+	{"V_DrawFadeConsBack", V_BenchFadeConsBack},
+	{"V_DrawFillConsoleMap", V_BenchFillConsoleMap},
+	{"V_DrawScaledPatch", V_BenchPatch},
+	{"V_DrawMappedPatch", V_BenchMappedPatch},
+	{"V_DrawScaledPatch translucent", V_BenchTransPatch},
+	{"V_DrawScaledPatch flipped", V_BenchFlippedPatch},
+	{"V_DrawFixedPatch 1.5x", V_BenchScaledPatch},
+	{"V_DrawString", V_BenchString},
+	{"V_DrawString translucent", V_BenchTransString},
+	{"V_DrawString changing", V_BenchChangingString},
+	{"V_DoPostProcessor water", V_BenchWater},
+	{"V_DoPostProcessor flip", V_BenchFlip},
+#if NUMSCREENS >= 5
+	{"V_DoPostProcessor motion", V_BenchMotion},
+	{"F_RunWipe frame", V_BenchWipe},
 #endif
+	{NULL, NULL}
+};
+
+//
+// Command_HudBench_f
+// Times the 2D drawers the HUD, menus and console are made of, and the
+// postprocessing effects and wipes drawn over them, each going over the
+// whole screen; run it in a 1920x1080 mode to see them at their worst.
+// The checksum of what each one leaves on the screen doesn't depend on
+// what was there before, so it can be compared between builds to make
+// sure they all draw the same thing.
+//
+void Command_HudBench_f(void)
+{
+	hudbench_t *bench;
+	INT32 frames = 20, frame;
+	size_t i, screensize;
+
+	if (rendermode != render_soft)
+	{
+		CONS_Printf(M_GetText("hudbench only works in software mode.\n"));
+		return;
+	}
+
+	if (!hu_font['S' - HU_FONTSTART])
+		return;
+
+	if (COM_Argc() > 1)
+		frames = max(1, atoi(COM_Argv(1)));
+
+	screensize = vid.rowbytes * vid.height;
+	CONS_Printf(M_GetText("%dx%d, %d frames:\n"), vid.width, vid.height, frames);
+
+	for (bench = hudbenches; bench->name; bench++)
+	{
+		precise_t start;
+		INT32 us;
+		UINT32 checksum = 2166136261u;
+
+		for (i = 0; i < screensize; i++)
+			screens[0][i] = (UINT8)(i ^ (i >> 9));
+
+		start = I_GetPreciseTime();
+		for (frame = 0; frame < frames; frame++)
+			bench->func(frame);
+		us = I_PreciseToMicros(I_GetPreciseTime() - start);
+		if (us <= 0)
+			us = 1;
+
+		for (i = 0; i < screensize; i++)
+			checksum = (checksum ^ screens[0][i]) * 16777619u;
+
+		CONS_Printf("%-30s %6d us %5d us/frame  %08x\n", bench->name, us, us / frames, checksum);
+	}
 }
 
 // V_Init
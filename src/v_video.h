@@ -176,6 +176,13 @@ void V_DrawRightAlignedThinString(INT32 x, INT32 y, INT32 option, const char *st
 
 void V_DrawStringAtFixed(fixed_t x, fixed_t y, INT32 option, const char *string);
 
+// draw a line of the console's text buffer, returning the color it ends in
+INT32 V_DrawConsoleLine(INT32 x, INT32 y, INT32 charflags, INT32 option, INT32 charwidth,
+	const UINT8 *line, size_t count, boolean lowercase);
+
+// forget the cached text runs the string drawers blit from
+void V_FlushTextRuns(void);
+
 // Draw tall nums, used for menu, HUD, intermission
 void V_DrawTallNum(INT32 x, INT32 y, INT32 flags, INT32 num);
 void V_DrawPaddedTallNum(INT32 x, INT32 y, INT32 flags, INT32 num, INT32 digits);
@@ -198,6 +205,8 @@ void V_DoPostProcessor(INT32 view, postimg_t type, INT32 param);
 
 void V_DrawPatchFill(patch_t *pat);
 
+void Command_HudBench_f(void);
+
 void VID_BlitLinearScreen(const UINT8 *srcptr, UINT8 *destptr, INT32 width, INT32 height, size_t srcrowbytes,
 	size_t destrowbytes);
 
@@ -3482,6 +3482,31 @@ char *I_ClipboardPaste(void)
 	return NULL;
 }
 
+void I_RunParallel(INT32 count, void (*func)(INT32 index, void *userdata), void *userdata)
+{
+	INT32 i;
+	for (i = 0; i < count; i++)
+		func(i, userdata);
+}
+
+precise_t I_GetPreciseTime(void)
+{
+	LARGE_INTEGER counter;
+	if (QueryPerformanceCounter(&counter))
+		return (precise_t)counter.QuadPart;
+	return (precise_t)GetTickCount();
+}
+
+int I_PreciseToMicros(precise_t d)
+{
+	static LARGE_INTEGER frequency = {{0, 0}};
+	if (!frequency.QuadPart && !QueryPerformanceFrequency(&frequency))
+		frequency.QuadPart = -1;
+	if (frequency.QuadPart <= 0) // GetTickCount, milliseconds
+		return (int)(d * 1000);
+	return (int)(d * 1000000 / frequency.QuadPart);
+}
+
 typedef BOOL (WINAPI *MyFunc3) (DWORD);
 
 const CPUInfoFlags *I_CPUInfo(void)